@@ -0,0 +1,24 @@
+#pragma once
+
+//Binding of threads to logical CPUs (used by benchmark timing and by thread pool).
+
+#if defined(_WIN32)
+  #define NOMINMAX
+  #include <windows.h>
+#elif defined(__linux__)
+  #include <sched.h>
+#endif
+
+//binds current thread to given logical CPU, returns false on failure
+static inline bool pin_to_cpu(int cpu) {
+#if defined(_WIN32)
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
@@ -7,6 +7,7 @@ enum class Alignment : size_t
     Normal = sizeof(void*),
     SSE    = 16,
     AVX    = 32,
+    Page   = 4096,
 };
 
 
@@ -155,6 +156,34 @@ public:
     { p->~T(); }
 };
 
+//Allocator for first-touch placement of pages on NUMA systems: vector(n) leaves elements of trivial types
+//uninitialized, so memory pages are not touched until the thread which owns them writes them (see first_touch)
+template <typename T, Alignment Align = Alignment::Page>
+class FirstTouchAllocator : public AlignedAllocator<T, Align>
+{
+public:
+    template <class U>
+    struct rebind { typedef FirstTouchAllocator<U, Align> other; };
+
+public:
+    FirstTouchAllocator() noexcept
+    {}
+
+    template <class U>
+    FirstTouchAllocator(const FirstTouchAllocator<U, Align>&) noexcept
+    {}
+
+    template <class U>
+    void
+    construct(U* p)
+    { ::new(reinterpret_cast<void*>(p)) U; }
+
+    template <class U, class ...Args>
+    void
+    construct(U* p, Args&&... args)
+    { ::new(reinterpret_cast<void*>(p)) U(std::forward<Args>(args)...); }
+};
+
 template <typename T, Alignment TAlign, typename U, Alignment UAlign>
 inline
 bool
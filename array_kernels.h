@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "vector_traits.h"
+
+//Applies vector kernel Func to array of arbitrary length n.
+//Arrays need not be aligned. Output must either coincide with input (in-place)
+//or not overlap it at all.
+//
+//Head elements before the first aligned output vector and tail elements after the last one
+//are processed with masked load/store when in-place, and with overlapping unaligned vectors otherwise.
+//Output larger than stream_threshold bytes is written with non-temporal stores,
+//so that it does not evict useful data from cache.
+template<class V, typename V::vec (*Func)(typename V::vec)>
+static void apply_array(typename V::elem *out, const typename V::elem *in, size_t n, size_t stream_threshold = size_t(-1)) {
+  typedef typename V::elem elem;
+  const size_t W = V::width;
+  if (n < W) {
+    if (n > 0)
+      V::store_partial(out, n, Func(V::load_partial(in, n)));
+    return;
+  }
+  bool inplace = (out == in);
+
+  size_t head = (size_t(0) - uintptr_t(out)) % sizeof(typename V::vec) / sizeof(elem);
+  if (head > 0) {
+    if (inplace)
+      V::store_partial(out, head, Func(V::load_partial(in, head)));
+    else
+      V::storeu(out, Func(V::loadu(in)));
+  }
+
+  size_t i = head;
+  if (n * sizeof(elem) > stream_threshold) {
+    for (; i + W <= n; i += W)
+      V::stream(out + i, Func(V::loadu(in + i)));
+    _mm_sfence();
+  }
+  else {
+    for (; i + W <= n; i += W)
+      V::store(out + i, Func(V::loadu(in + i)));
+  }
+
+  if (i < n) {
+    if (inplace)
+      V::store_partial(out + i, n - i, Func(V::load_partial(in + i, n - i)));
+    else
+      V::storeu(out + n - W, Func(V::loadu(in + n - W)));
+  }
+}
+
+//same for binary kernel: out[i] = Func(a[i], b[i]), output may be equal to a or b
+template<class V, typename V::vec (*Func)(typename V::vec, typename V::vec)>
+static void apply_array2(typename V::elem *out, const typename V::elem *a, const typename V::elem *b, size_t n, size_t stream_threshold = size_t(-1)) {
+  typedef typename V::elem elem;
+  const size_t W = V::width;
+  if (n < W) {
+    if (n > 0)
+      V::store_partial(out, n, Func(V::load_partial(a, n), V::load_partial(b, n)));
+    return;
+  }
+  bool inplace = (out == a || out == b);
+
+  size_t head = (size_t(0) - uintptr_t(out)) % sizeof(typename V::vec) / sizeof(elem);
+  if (head > 0) {
+    if (inplace)
+      V::store_partial(out, head, Func(V::load_partial(a, head), V::load_partial(b, head)));
+    else
+      V::storeu(out, Func(V::loadu(a), V::loadu(b)));
+  }
+
+  size_t i = head;
+  if (n * sizeof(elem) > stream_threshold) {
+    for (; i + W <= n; i += W)
+      V::stream(out + i, Func(V::loadu(a + i), V::loadu(b + i)));
+    _mm_sfence();
+  }
+  else {
+    for (; i + W <= n; i += W)
+      V::store(out + i, Func(V::loadu(a + i), V::loadu(b + i)));
+  }
+
+  if (i < n) {
+    if (inplace)
+      V::store_partial(out + i, n - i, Func(V::load_partial(a + i, n - i), V::load_partial(b + i, n - i)));
+    else
+      V::storeu(out + n - W, Func(V::loadu(a + n - W), V::loadu(b + n - W)));
+  }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+//Compiler baselines: plain loops out[i] = 1 / in[i] and out[i] = 1 / sqrt(in[i]) without intrinsics.
+//Each autovec_<variant>.cpp compiles them with its own flags (scalar, auto-vectorized with -ffast-math, with -mrecip),
+//so the benchmark can compare hand-written kernels with what the compiler generates for the same instruction set.
+//Input and output must not overlap.
+
+#include <stddef.h>
+
+struct AutovecBaseline {
+  const char *name;     //variant, e.g. "avx2_recip"
+  const char *isa;      //instruction set enabled when compiling: "sse2", "avx2" or "avx512"
+  const char *flags;    //flags the variant must be compiled with (see README)
+  void (*recip_float)(float *out, const float *in, size_t n);
+  void (*recip_double)(double *out, const double *in, size_t n);
+  void (*rsqrt_float)(float *out, const float *in, size_t n);
+  void (*rsqrt_double)(double *out, const double *in, size_t n);
+};
+
+extern const AutovecBaseline autovec_scalar;
+extern const AutovecBaseline autovec_sse2;
+extern const AutovecBaseline autovec_sse2_recip;
+extern const AutovecBaseline autovec_avx2;
+extern const AutovecBaseline autovec_avx2_recip;
+extern const AutovecBaseline autovec_avx512;
+extern const AutovecBaseline autovec_avx512_recip;
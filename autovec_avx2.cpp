@@ -0,0 +1,5 @@
+//compiler baseline: auto-vectorized for AVX2 + FMA, IEEE division and square root
+//must be compiled with -O3 -fno-math-errno -mavx2 -mfma
+#define AUTOVEC_VARIANT avx2
+#define AUTOVEC_FLAGS "-O3 -fno-math-errno -mavx2 -mfma"
+#include "autovec_impl.h"
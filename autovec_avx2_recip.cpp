@@ -0,0 +1,5 @@
+//compiler baseline: auto-vectorized for AVX2 + FMA with approximations (vrcpps / vrsqrtps + Newton step)
+//must be compiled with -O3 -ffast-math -mrecip -mavx2 -mfma
+#define AUTOVEC_VARIANT avx2_recip
+#define AUTOVEC_FLAGS "-O3 -ffast-math -mrecip -mavx2 -mfma"
+#include "autovec_impl.h"
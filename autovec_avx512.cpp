@@ -0,0 +1,5 @@
+//compiler baseline: auto-vectorized for AVX-512, IEEE division and square root
+//must be compiled with -O3 -fno-math-errno -mavx512f -mprefer-vector-width=512
+#define AUTOVEC_VARIANT avx512
+#define AUTOVEC_FLAGS "-O3 -fno-math-errno -mavx512f -mprefer-vector-width=512"
+#include "autovec_impl.h"
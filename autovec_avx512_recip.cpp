@@ -0,0 +1,5 @@
+//compiler baseline: auto-vectorized for AVX-512 with approximations (vrcp14ps / vrsqrt14ps + Newton step)
+//must be compiled with -O3 -ffast-math -mrecip -mavx512f -mprefer-vector-width=512
+#define AUTOVEC_VARIANT avx512_recip
+#define AUTOVEC_FLAGS "-O3 -ffast-math -mrecip -mavx512f -mprefer-vector-width=512"
+#include "autovec_impl.h"
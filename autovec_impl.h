@@ -0,0 +1,42 @@
+#pragma once
+
+//Loops of compiler baselines (see autovec.h).
+//Included by autovec_<variant>.cpp after defining AUTOVEC_VARIANT and AUTOVEC_FLAGS.
+
+#include <cmath>
+#include "autovec.h"
+
+#define AUTOVEC_JOIN2(a, b) a##b
+#define AUTOVEC_JOIN(a, b) AUTOVEC_JOIN2(a, b)
+#define AUTOVEC_STRING2(a) #a
+#define AUTOVEC_STRING(a) AUTOVEC_STRING2(a)
+
+#if defined(__AVX512F__)
+  #define AUTOVEC_ISA "avx512"
+#elif defined(__AVX2__)
+  #define AUTOVEC_ISA "avx2"
+#else
+  #define AUTOVEC_ISA "sse2"
+#endif
+
+static void recip_float_loop(float *__restrict out, const float *__restrict in, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = 1.0f / in[i];
+}
+static void recip_double_loop(double *__restrict out, const double *__restrict in, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = 1.0 / in[i];
+}
+static void rsqrt_float_loop(float *__restrict out, const float *__restrict in, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = 1.0f / std::sqrt(in[i]);
+}
+static void rsqrt_double_loop(double *__restrict out, const double *__restrict in, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    out[i] = 1.0 / std::sqrt(in[i]);
+}
+
+const AutovecBaseline AUTOVEC_JOIN(autovec_, AUTOVEC_VARIANT) = {
+  AUTOVEC_STRING(AUTOVEC_VARIANT), AUTOVEC_ISA, AUTOVEC_FLAGS,
+  recip_float_loop, recip_double_loop, rsqrt_float_loop, rsqrt_double_loop
+};
@@ -0,0 +1,5 @@
+//compiler baseline: scalar code with IEEE division and square root
+//must be compiled with -O2 -fno-tree-vectorize
+#define AUTOVEC_VARIANT scalar
+#define AUTOVEC_FLAGS "-O2 -fno-tree-vectorize"
+#include "autovec_impl.h"
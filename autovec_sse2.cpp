@@ -0,0 +1,5 @@
+//compiler baseline: auto-vectorized for SSE2, IEEE division and square root
+//must be compiled with -O3 -fno-math-errno
+#define AUTOVEC_VARIANT sse2
+#define AUTOVEC_FLAGS "-O3 -fno-math-errno"
+#include "autovec_impl.h"
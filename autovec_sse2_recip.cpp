@@ -0,0 +1,5 @@
+//compiler baseline: auto-vectorized for SSE2 with approximations (rcpps / rsqrtps + Newton step)
+//must be compiled with -O3 -ffast-math -mrecip
+#define AUTOVEC_VARIANT sse2_recip
+#define AUTOVEC_FLAGS "-O3 -ffast-math -mrecip"
+#include "autovec_impl.h"
@@ -0,0 +1,7 @@
+#pragma once
+
+#if defined(_MSC_VER)
+  #define FORCEINLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+  #define FORCEINLINE inline __attribute__((always_inline))
+#endif
@@ -0,0 +1,207 @@
+#pragma once
+
+//Correctly rounded recip and rsqrt of doubles (round to nearest). Both start from r5 kernel (error below 0.52 ulp for recip,
+//1.1 ulp for rsqrt) and need FMA for the final step, so they are compiled only with FMA.
+//As r5, they support only inputs within float range. rsqrt_*_cr is faster than sqrtpd + divpd, while recip_*_cr
+//pays off only on cores where divpd is not pipelined.
+//
+//  recip_*_fma:   q = y + y (1 - a y), residual is exact with FMA. By Markstein's theorem, if y is within 1 ulp of 1/a,
+//                 q is correctly rounded unless mantissa of a is all ones: then 1/a is 2^-e (1 + 2^-53 + 2^-106 + ...),
+//                 just above a midpoint, and q can be rounded down.
+//  recip_*_cr:    same with the only exception fixed: bit pattern of result is 0x7FE0000000000000 - bits(a).
+//                 Result is always correctly rounded.
+//  rsqrt_*_fma:   residual r = 1 - a y^2 is computed with error below 2^-102 (y^2 is split into two doubles by FMA),
+//                 then q = y + y (r/2 + 3r^2/8). Error of q before rounding is below 2^-100 relative,
+//                 so error is below 0.5 + 2^-47 ulp.
+//  rsqrt_*_cr:    Ziv's rounding test: q is correct if y + y c +- 2^-96 y (eps) round to the same value.
+//                 Lanes failing the test (about 2^-43 of random inputs, but many of the hard cases) are fixed
+//                 by exact integer comparison with midpoints (round_rsqrt_exact).
+//
+//Exact helpers compare x m^k with 1 for midpoint m between neighbouring doubles, using integer arithmetic on 32-bit limbs.
+//They are also used to verify correct rounding, where double-double reference is not precise enough:
+//1/a and 1/sqrt(a) can be as close as 2^-106 (relative) to a midpoint, e.g. for a = 1 - k 2^-53.
+//
+//Include after routines_sse.h and routines_avx.h.
+
+#include <stdint.h>
+#include <string.h>
+#include "compiler.h"
+
+//positive normal double x = mant * 2^exp, mant has 53 bits
+static inline uint64_t double_mantissa(double x, int *exp) {
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  *exp = int(bits >> 52) - 1075;
+  return (bits & ((1ULL << 52) - 1)) | (1ULL << 52);
+}
+
+//exact sign of x m^k - 1, where m = mant * 2^exp and k = 1 or 2
+static inline int midpoint_sign(double x, uint64_t mant, int exp, int k) {
+  int xe;
+  uint64_t xm = double_mantissa(x, &xe);
+  //product xm * mant^k in 32-bit limbs (at most 53 + 2 * 55 bits)
+  uint32_t prod[6] = {uint32_t(xm), uint32_t(xm >> 32)};
+  int len = 2;
+  for (int i = 0; i < k; i++) {
+    uint32_t m[2] = {uint32_t(mant), uint32_t(mant >> 32)};
+    uint32_t res[6] = {0};
+    for (int a = 0; a < len; a++) {
+      uint64_t carry = 0;
+      for (int b = 0; b < 2; b++) {
+        uint64_t t = uint64_t(prod[a]) * m[b] + res[a + b] + carry;
+        res[a + b] = uint32_t(t);
+        carry = t >> 32;
+      }
+      res[a + 2] = uint32_t(carry);
+    }
+    len += 2;
+    memcpy(prod, res, sizeof(prod));
+  }
+  //compare product with 2^p, where x m^k = product * 2^(xe + k exp)
+  int p = -(xe + k * exp);
+  int top = len - 1;
+  while (prod[top] == 0)
+    top--;
+  int bit = 31;
+  while (!(prod[top] >> bit))
+    bit--;
+  int highest = 32 * top + bit;
+  if (highest != p)
+    return highest > p ? 1 : -1;
+  if (prod[top] != (1U << bit))
+    return 1;
+  for (int i = 0; i < top; i++)
+    if (prod[i] != 0)
+      return 1;
+  return 0;
+}
+
+//q is f(x) = x^(-1/k) correctly rounded: f(x) lies between midpoints around q, i.e. x m_low^k < 1 < x m_high^k
+//(ties are impossible except for exact results, which are representable)
+static inline bool is_rounded_inverse_root(double x, double q, int k) {
+  int e;
+  uint64_t m = double_mantissa(q, &e);
+  bool powerOfTwo = (m == (1ULL << 52));
+  int low = (powerOfTwo ? midpoint_sign(x, 4 * m - 1, e - 2, k) : midpoint_sign(x, 2 * m - 1, e - 1, k));
+  return low <= 0 && midpoint_sign(x, 2 * m + 1, e - 1, k) > 0;
+}
+static inline bool is_correctly_rounded_recip(double x, double q) { return is_rounded_inverse_root(x, q, 1); }
+static inline bool is_correctly_rounded_rsqrt(double x, double q) { return is_rounded_inverse_root(x, q, 2); }
+
+static inline double next_double(double x, int64_t step) {
+  int64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  bits += step;
+  memcpy(&x, &bits, sizeof(bits));
+  return x;
+}
+
+//correctly rounded 1/sqrt(x) from faithful approximation q
+static inline double round_rsqrt_exact(double x, double q) {
+  if (is_correctly_rounded_rsqrt(x, q))
+    return q;
+  double up = next_double(q, 1);
+  return is_correctly_rounded_rsqrt(x, up) ? up : next_double(q, -1);
+}
+
+#ifdef __FMA__
+
+static FORCEINLINE __m128d recip_double2_fma(__m128d a) {
+  __m128d y = recip_double2_r5(a);
+  return _mm_fmadd_pd(y, _mm_fnmadd_pd(a, y, _mm_set1_pd(1.0)), y);
+}
+static FORCEINLINE __m128d recip_double2_cr(__m128d a) {
+  __m128d q = recip_double2_fma(a);
+  __m128i bits = _mm_castpd_si128(a);
+  __m128i mant = _mm_set1_epi64x((1LL << 52) - 1);
+  __m128i allOnes = _mm_cmpeq_epi64(_mm_and_si128(bits, mant), mant);
+  __m128i fixed = _mm_sub_epi64(_mm_set1_epi64x(0x7FE0000000000000LL), bits);
+  return _mm_blendv_pd(q, _mm_castsi128_pd(fixed), _mm_castsi128_pd(allOnes));
+}
+
+//y + y c, where c = (1 - r)^(-1/2) - 1 and y = rsqrt_double2_r5(a)
+static FORCEINLINE void rsqrt_double2_step(__m128d a, __m128d &y, __m128d &yc) {
+  __m128d one = _mm_set1_pd(1.0);
+  y = rsqrt_double2_r5(a);
+  __m128d y2 = _mm_mul_pd(y, y);
+  __m128d y2lo = _mm_fmsub_pd(y, y, y2);
+  __m128d r = _mm_fnmadd_pd(a, y2lo, _mm_fnmadd_pd(a, y2, one));
+  __m128d c = _mm_mul_pd(r, _mm_fmadd_pd(r, _mm_set1_pd(3.0 / 8.0), _mm_set1_pd(0.5)));
+  yc = _mm_mul_pd(y, c);
+}
+static FORCEINLINE __m128d rsqrt_double2_fma(__m128d a) {
+  __m128d y, yc;
+  rsqrt_double2_step(a, y, yc);
+  return _mm_add_pd(y, yc);
+}
+static FORCEINLINE __m128d rsqrt_double2_cr(__m128d a) {
+  __m128d y, yc;
+  rsqrt_double2_step(a, y, yc);
+  __m128d q = _mm_add_pd(y, yc);
+  __m128d eps = _mm_mul_pd(y, _mm_set1_pd(1.0 / 79228162514264337593543950336.0));
+  __m128d high = _mm_add_pd(y, _mm_add_pd(yc, eps));
+  __m128d low = _mm_add_pd(y, _mm_sub_pd(yc, eps));
+  int hard = _mm_movemask_pd(_mm_cmpneq_pd(high, low));
+  if (hard) {
+    double x[2], res[2];
+    _mm_storeu_pd(x, a);
+    _mm_storeu_pd(res, q);
+    for (int i = 0; i < 2; i++)
+      if (hard & (1 << i))
+        res[i] = round_rsqrt_exact(x[i], res[i]);
+    q = _mm_loadu_pd(res);
+  }
+  return q;
+}
+
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+static FORCEINLINE __m256d recip_double4_fma(__m256d a) {
+  __m256d y = recip_double4_r5(a);
+  return _mm256_fmadd_pd(y, _mm256_fnmadd_pd(a, y, _mm256_set1_pd(1.0)), y);
+}
+static FORCEINLINE __m256d recip_double4_cr(__m256d a) {
+  __m256d q = recip_double4_fma(a);
+  __m256i bits = _mm256_castpd_si256(a);
+  __m256i mant = _mm256_set1_epi64x((1LL << 52) - 1);
+  __m256i allOnes = _mm256_cmpeq_epi64(_mm256_and_si256(bits, mant), mant);
+  __m256i fixed = _mm256_sub_epi64(_mm256_set1_epi64x(0x7FE0000000000000LL), bits);
+  return _mm256_blendv_pd(q, _mm256_castsi256_pd(fixed), _mm256_castsi256_pd(allOnes));
+}
+
+static FORCEINLINE void rsqrt_double4_step(__m256d a, __m256d &y, __m256d &yc) {
+  __m256d one = _mm256_set1_pd(1.0);
+  y = rsqrt_double4_r5(a);
+  __m256d y2 = _mm256_mul_pd(y, y);
+  __m256d y2lo = _mm256_fmsub_pd(y, y, y2);
+  __m256d r = _mm256_fnmadd_pd(a, y2lo, _mm256_fnmadd_pd(a, y2, one));
+  __m256d c = _mm256_mul_pd(r, _mm256_fmadd_pd(r, _mm256_set1_pd(3.0 / 8.0), _mm256_set1_pd(0.5)));
+  yc = _mm256_mul_pd(y, c);
+}
+static FORCEINLINE __m256d rsqrt_double4_fma(__m256d a) {
+  __m256d y, yc;
+  rsqrt_double4_step(a, y, yc);
+  return _mm256_add_pd(y, yc);
+}
+static FORCEINLINE __m256d rsqrt_double4_cr(__m256d a) {
+  __m256d y, yc;
+  rsqrt_double4_step(a, y, yc);
+  __m256d q = _mm256_add_pd(y, yc);
+  __m256d eps = _mm256_mul_pd(y, _mm256_set1_pd(1.0 / 79228162514264337593543950336.0));
+  __m256d high = _mm256_add_pd(y, _mm256_add_pd(yc, eps));
+  __m256d low = _mm256_add_pd(y, _mm256_sub_pd(yc, eps));
+  int hard = _mm256_movemask_pd(_mm256_cmp_pd(high, low, _CMP_NEQ_UQ));
+  if (hard) {
+    double x[4], res[4];
+    _mm256_storeu_pd(x, a);
+    _mm256_storeu_pd(res, q);
+    for (int i = 0; i < 4; i++)
+      if (hard & (1 << i))
+        res[i] = round_rsqrt_exact(x[i], res[i]);
+    q = _mm256_loadu_pd(res);
+  }
+  return q;
+}
+#endif
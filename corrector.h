@@ -0,0 +1,123 @@
+#pragma once
+
+//Compile-time generator of relative correctors (see routines_sse.h) for any vector type from vector_traits.h,
+//approximating a^(-1/n) for n = 1 (recip), 2 (rsqrt), 3 (rcbrt), 4 (rqrt):
+//   r := 1 - a x^n;
+//   x := x + x r q(r),   where q(r) = a_1 + a_2 r + ... + a_{N-1} r^{N-2}
+//Coefficients come from the binomial series (1 - r)^(-1/n) = 1 + a_1 r + a_2 r^2 + ...
+//N is the order of method. Polynomial q is evaluated either by Horner scheme,
+//or by Estrin scheme: it computes halves of polynomial independently, so latency is shorter,
+//but powers of r cost extra multiplications.
+//Minimax variant (corrected_minimax) uses coefficients fitted by remez.cpp instead of Taylor series.
+
+#include "vector_traits.h"
+#include "minimax_coefs.h"
+
+enum class CorrectorFunc { Recip, Rsqrt, Rcbrt, Rqrt };
+enum class PolyScheme { Horner, Estrin };
+
+//n in a^(-1/n)
+constexpr int corrector_degree(CorrectorFunc func) {
+  return func == CorrectorFunc::Recip ? 1 : func == CorrectorFunc::Rsqrt ? 2 : func == CorrectorFunc::Rcbrt ? 3 : 4;
+}
+
+//a_k of series poly(r): a_k = a_{k-1} (1/n + k - 1) / k, i.e. 1 for recip, (2k-1)!! / (2^k k!) for rsqrt
+constexpr double corrector_coef(CorrectorFunc func, int k) {
+  return k == 0 ? 1.0 : corrector_coef(func, k - 1) * (1 + corrector_degree(func) * (k - 1)) / (corrector_degree(func) * k);
+}
+
+//coefficient providers for CorrectorPoly
+template<CorrectorFunc Func> struct TaylorCoefs {
+  static constexpr double get(int k) { return corrector_coef(Func, k); }
+};
+template<CorrectorFunc Func, int Order> struct MinimaxCoefs {
+  static constexpr double get(int k) {
+    return Func == CorrectorFunc::Recip ? minimax_recip_coefs[Order][k] : minimax_rsqrt_coefs[Order][k];
+  }
+};
+
+//the largest power of two less than n
+constexpr int estrin_split(int n, int p = 1) {
+  return 2 * p < n ? estrin_split(n, 2 * p) : p;
+}
+
+//r^N for N = power of two
+template<class V, int N> struct PowerOfTwo {
+  static FORCEINLINE typename V::vec eval(typename V::vec r) {
+    typename V::vec half = PowerOfTwo<V, N / 2>::eval(r);
+    return V::mul(half, half);
+  }
+};
+template<class V> struct PowerOfTwo<V, 1> {
+  static FORCEINLINE typename V::vec eval(typename V::vec r) { return r; }
+};
+
+//sum of Coefs::get(First+i) r^i over i in [0, Count)
+template<class V, class Coefs, int First, int Count, PolyScheme Scheme> struct CorrectorPoly;
+
+template<class V, class Coefs, int First, int Count> struct CorrectorPoly<V, Coefs, First, Count, PolyScheme::Horner> {
+  static FORCEINLINE typename V::vec eval(typename V::vec r) {
+    typename V::vec rest = CorrectorPoly<V, Coefs, First + 1, Count - 1, PolyScheme::Horner>::eval(r);
+    return V::fmadd(rest, r, V::set1(typename V::elem(Coefs::get(First))));
+  }
+};
+template<class V, class Coefs, int First> struct CorrectorPoly<V, Coefs, First, 1, PolyScheme::Horner> {
+  static FORCEINLINE typename V::vec eval(typename V::vec) {
+    return V::set1(typename V::elem(Coefs::get(First)));
+  }
+};
+
+template<class V, class Coefs, int First, int Count> struct CorrectorPoly<V, Coefs, First, Count, PolyScheme::Estrin> {
+  enum { Low = estrin_split(Count) };
+  static FORCEINLINE typename V::vec eval(typename V::vec r) {
+    typename V::vec low = CorrectorPoly<V, Coefs, First, Low, PolyScheme::Estrin>::eval(r);
+    typename V::vec high = CorrectorPoly<V, Coefs, First + Low, Count - Low, PolyScheme::Estrin>::eval(r);
+    return V::fmadd(high, PowerOfTwo<V, Low>::eval(r), low);
+  }
+};
+template<class V, class Coefs, int First> struct CorrectorPoly<V, Coefs, First, 1, PolyScheme::Estrin> {
+  static FORCEINLINE typename V::vec eval(typename V::vec) {
+    return V::set1(typename V::elem(Coefs::get(First)));
+  }
+};
+
+//residual r = 1 - a x^n
+template<class V, CorrectorFunc Func>
+static FORCEINLINE typename V::vec corrector_residual(typename V::vec a, typename V::vec x) {
+  typedef typename V::vec vec;
+  vec one = V::set1(typename V::elem(1));
+  if (Func == CorrectorFunc::Recip)
+    return V::fnmadd(a, x, one);
+  if (Func == CorrectorFunc::Rsqrt)
+    return V::fnmadd(V::mul(a, x), x, one);
+  if (Func == CorrectorFunc::Rcbrt)
+    return V::fnmadd(V::mul(a, x), V::mul(x, x), one);
+  vec x2 = V::mul(x, x);
+  return V::fnmadd(V::mul(a, x2), x2, one);
+}
+
+//seed from kernel Seed (e.g. recip_double2_fast), followed by corrector of given order
+template<class V, typename V::vec (*Seed)(typename V::vec), CorrectorFunc Func, int Order, PolyScheme Scheme>
+static FORCEINLINE typename V::vec corrected(typename V::vec a) {
+  static_assert(Order >= 2, "corrector order must be at least 2");
+  typedef typename V::vec vec;
+  vec x = Seed(a);
+  vec r = corrector_residual<V, Func>(a, x);
+  vec q = CorrectorPoly<V, TaylorCoefs<Func>, 1, Order - 1, Scheme>::eval(r);
+  return V::fmadd(V::mul(x, r), q, x);
+}
+
+//same with minimax coefficients: x := x + x D(r), where D(r) = P(r) - 1 = d_0 + r q(r) has nonzero constant term;
+//x + x d_0 is computed in parallel with q(r), so latency is the same as with Taylor coefficients
+template<class V, typename V::vec (*Seed)(typename V::vec), CorrectorFunc Func, int Order, PolyScheme Scheme>
+static FORCEINLINE typename V::vec corrected_minimax(typename V::vec a) {
+  static_assert(Order >= 2 && Order <= 6, "minimax coefficients are fitted for orders 2..6");
+  static_assert(Func == CorrectorFunc::Recip || Func == CorrectorFunc::Rsqrt, "minimax coefficients are fitted for recip and rsqrt only");
+  typedef typename V::vec vec;
+  typedef MinimaxCoefs<Func, Order> Coefs;
+  vec x = Seed(a);
+  vec r = corrector_residual<V, Func>(a, x);
+  vec q = CorrectorPoly<V, Coefs, 1, Order - 1, Scheme>::eval(r);
+  vec x0 = V::fmadd(x, V::set1(typename V::elem(Coefs::get(0))), x);
+  return V::fmadd(V::mul(x, r), q, x0);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stddef.h>
+
+//Runtime detection of instruction sets via CPUID.
+//Extended register state must also be enabled by OS, which is checked via XGETBV.
+//Do not include it into translation units compiled with non-baseline ISA flags.
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+  #include <immintrin.h>
+  static inline void cpuid(int info[4], int leaf, int subleaf) {
+    __cpuidex(info, leaf, subleaf);
+  }
+  static inline unsigned long long xgetbv0() {
+    return _xgetbv(0);
+  }
+#elif defined(__GNUC__) || defined(__clang__)
+  #include <cpuid.h>
+  static inline void cpuid(int info[4], int leaf, int subleaf) {
+    unsigned a, b, c, d;
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+    info[0] = a;  info[1] = b;  info[2] = c;  info[3] = d;
+  }
+  static inline unsigned long long xgetbv0() {
+    unsigned lo, hi;
+    __asm__ __volatile__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((unsigned long long)hi << 32) | lo;
+  }
+#endif
+
+struct CpuFeatures {
+  bool intel;     //vendor is GenuineIntel
+  bool sse2;
+  bool avx;
+  bool avx2;
+  bool fma;
+  bool f16c;
+  bool avx512f;
+};
+
+static inline CpuFeatures detect_cpu_features() {
+  CpuFeatures res = {};
+  int info[4];
+  cpuid(info, 0, 0);
+  int maxLeaf = info[0];
+  //vendor string is stored in EBX, EDX, ECX
+  res.intel = (info[1] == 0x756e6547 && info[3] == 0x49656e69 && info[2] == 0x6c65746e);
+  if (maxLeaf < 1)
+    return res;
+
+  cpuid(info, 1, 0);
+  res.sse2 = (info[3] >> 26) & 1;
+  bool osxsave = (info[2] >> 27) & 1;
+  bool avx = (info[2] >> 28) & 1;
+  bool fma = (info[2] >> 12) & 1;
+  bool f16c = (info[2] >> 29) & 1;
+
+  //XCR0: bits 1-2 = XMM/YMM state, bits 5-7 = opmask/ZMM state
+  unsigned long long xcr0 = osxsave ? xgetbv0() : 0;
+  bool osYmm = (xcr0 & 0x06) == 0x06;
+  bool osZmm = (xcr0 & 0xE6) == 0xE6;
+
+  res.avx = avx && osYmm;
+  res.fma = fma && res.avx;
+  res.f16c = f16c && res.avx;
+  if (maxLeaf >= 7) {
+    cpuid(info, 7, 0);
+    res.avx2 = ((info[1] >> 5) & 1) && res.avx;
+    res.avx512f = ((info[1] >> 16) & 1) && osZmm;
+  }
+  return res;
+}
+
+//size of data (or unified) cache of given level in bytes, the largest cache if level is 0; 0 if unknown
+//uses deterministic cache parameters: leaf 4 on Intel, leaf 0x8000001D on AMD
+static inline size_t detect_cache_size(int level) {
+  int info[4];
+  cpuid(info, 0, 0);
+  int maxLeaf = info[0];
+  cpuid(info, 0x80000000, 0);
+  unsigned maxExtLeaf = info[0];
+
+  int leaves[2] = {4, int(0x8000001D)};
+  bool available[2] = {maxLeaf >= 4, maxExtLeaf >= 0x8000001D};
+  size_t best = 0;
+  for (int l = 0; l < 2; l++) if (available[l]) {
+    for (int sub = 0; sub < 16; sub++) {
+      cpuid(info, leaves[l], sub);
+      int type = info[0] & 31;    //0 = no more caches, 2 = instruction cache
+      if (type == 0)
+        break;
+      if (type == 2 || (level > 0 && ((info[0] >> 5) & 7) != level))
+        continue;
+      size_t ways = ((unsigned(info[1]) >> 22) & 1023) + 1;
+      size_t partitions = ((unsigned(info[1]) >> 12) & 1023) + 1;
+      size_t lineSize = (unsigned(info[1]) & 4095) + 1;
+      size_t sets = unsigned(info[2]) + 1;
+      size_t size = ways * partitions * lineSize * sets;
+      if (best < size)
+        best = size;
+    }
+    if (best > 0)
+      break;
+  }
+  return best;
+}
+
+//size of the largest (usually last level) data cache in bytes, or 0 if unknown
+static inline size_t detect_last_level_cache_size() {
+  return detect_cache_size(0);
+}
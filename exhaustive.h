@@ -0,0 +1,124 @@
+#pragma once
+
+//Exhaustive precision check of float kernels over all 2^32 bit patterns (or a subrange).
+//Inputs are generated directly in registers, so no memory is needed for test values.
+//Bit patterns are split into chunks, which are grabbed dynamically by worker threads:
+//whichever thread is free takes the next chunk, so all cores stay busy until the end.
+
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "vector_traits.h"
+
+struct ExhaustiveResult {
+  //over all inputs with finite nonzero correct answer
+  double maxError;
+  uint32_t maxErrorInput;
+  //only over normal inputs with normal correct answer
+  double maxNormalError;
+  uint32_t maxNormalErrorInput;
+  //number of inputs where correct answer is zero, infinity or NaN, but result is different
+  unsigned long long mismatches;
+  uint32_t mismatchInput;   //the smallest one
+};
+
+static inline ExhaustiveResult exhaustive_result_init() {
+  ExhaustiveResult res = {0.0, 0, 0.0, 0, 0, 0xFFFFFFFFU};
+  return res;
+}
+
+static inline void exhaustive_update(double &maxErr, uint32_t &maxInput, double err, uint32_t input) {
+  if (err > maxErr || (err == maxErr && input < maxInput)) {
+    maxErr = err;
+    maxInput = input;
+  }
+}
+
+static inline void exhaustive_merge(ExhaustiveResult &dst, const ExhaustiveResult &src) {
+  exhaustive_update(dst.maxError, dst.maxErrorInput, src.maxError, src.maxErrorInput);
+  exhaustive_update(dst.maxNormalError, dst.maxNormalErrorInput, src.maxNormalError, src.maxNormalErrorInput);
+  dst.mismatches += src.mismatches;
+  if (dst.mismatchInput > src.mismatchInput)
+    dst.mismatchInput = src.mismatchInput;
+}
+
+//called for rare lanes flagged by vectorized filter
+static inline void exhaustive_check_lane(ExhaustiveResult &res, float x, float result, float answer) {
+  uint32_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  if (std::isfinite(answer) && answer != 0.0f) {
+    double err = std::isnan(result) ? INFINITY : std::fabs(double(result) - double(answer)) / std::fabs(double(answer));
+    exhaustive_update(res.maxError, res.maxErrorInput, err, bits);
+    if (std::isnormal(x) && std::isnormal(answer))
+      exhaustive_update(res.maxNormalError, res.maxNormalErrorInput, err, bits);
+  }
+  else {
+    res.mismatches++;
+    if (res.mismatchInput > bits)
+      res.mismatchInput = bits;
+  }
+}
+
+template<class V, typename V::vec (*Func)(typename V::vec), typename V::vec (*Correct)(typename V::vec)>
+static void exhaustive_worker(std::atomic<unsigned long long> *next, unsigned long long end, ExhaustiveResult *total, std::mutex *mutex) {
+  typedef typename V::vec vec;
+  const unsigned long long chunk = 1 << 20;
+  ExhaustiveResult res = exhaustive_result_init();
+
+  while (true) {
+    unsigned long long first = next->fetch_add(chunk);
+    if (first >= end)
+      break;
+    unsigned long long last = (first + chunk < end ? first + chunk : end);
+
+    vec threshold = V::set1(float(res.maxNormalError));
+    for (unsigned long long b = first; b < last; b += V::width) {
+      vec x = V::consecutive_bits(unsigned(b));
+      vec result = Func(x);
+      vec answer = Correct(x);
+      vec relative = V::div(V::abs(V::sub(result, answer)), V::abs(answer));
+      //lanes with larger error than known, or with special values (except exact matches);
+      //zero and infinite answers must match bit for bit, since IEEE comparison treats -0 and +0 as equal
+      vec absAnswer = V::abs(answer);
+      int special = V::eq_mask(absAnswer, V::set1(0.0f)) | V::eq_mask(absAnswer, V::set1(INFINITY));
+      int exact = (V::eq_mask(result, answer) & ~special) | V::same_bits_mask(result, answer);
+      int flagged = V::gt_mask(relative, threshold) | V::nan_mask(relative);
+      flagged &= ~(exact | (V::nan_mask(result) & V::nan_mask(answer)));
+      if (flagged) {
+        float xs[V::width], rs[V::width], as[V::width];
+        V::storeu(xs, x);
+        V::storeu(rs, result);
+        V::storeu(as, answer);
+        for (int j = 0; j < V::width; j++)
+          if ((flagged >> j) & 1)
+            exhaustive_check_lane(res, xs[j], rs[j], as[j]);
+        threshold = V::set1(float(res.maxNormalError));
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(*mutex);
+  exhaustive_merge(*total, res);
+}
+
+//checks all bit patterns in [first, last] (rounded outwards to vector width)
+template<class V, typename V::vec (*Func)(typename V::vec), typename V::vec (*Correct)(typename V::vec)>
+ExhaustiveResult test_exhaustive(uint32_t first, uint32_t last, int threadsNum) {
+  std::atomic<unsigned long long> next(first - first % V::width);
+  unsigned long long end = (unsigned long long)last + 1;
+  end += (V::width - end % V::width) % V::width;
+
+  ExhaustiveResult total = exhaustive_result_init();
+  std::mutex mutex;
+  std::vector<std::thread> threads;
+  for (int t = 1; t < threadsNum; t++)
+    threads.push_back(std::thread(exhaustive_worker<V, Func, Correct>, &next, end, &total, &mutex));
+  exhaustive_worker<V, Func, Correct>(&next, end, &total, &mutex);
+  for (size_t t = 0; t < threads.size(); t++)
+    threads[t].join();
+  return total;
+}
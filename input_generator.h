@@ -0,0 +1,117 @@
+#pragma once
+
+//Test inputs generated on the fly in small blocks instead of being stored in huge arrays.
+//Stream of test values is a pure function of index, so any block can be produced independently and instantly:
+//the first enumCount values are consecutive bit patterns starting from 1.0 (exact enumeration),
+//then come random values 2^e * (1 + m) with exponent e uniform in [minExp, maxExp) and uniformly random mantissa bits.
+//Random bits are a counter-based hash of index and seed computed in SSE registers (no generator state),
+//and values are assembled from exponent and mantissa bits directly, without calling exp2.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+#include <immintrin.h>
+#include <vector>
+#include "compiler.h"
+#include "vector_traits.h"
+#include "aligned_allocator.h"
+
+template<class T> struct InputStream {
+  size_t enumCount;     //enumerated values, then random ones
+  size_t size;          //total number of values
+  int minExp, maxExp;   //exponents of random values
+  uint32_t seed;
+};
+
+template<class T> InputStream<T> input_stream(size_t enumCount, size_t randomCount, int minExp, int maxExp, uint32_t seed) {
+  InputStream<T> res = {enumCount, enumCount + randomCount, minExp, maxExp, seed};
+  return res;
+}
+
+//values are generated by blocks of this size when whole stream is processed
+const size_t input_block_size = 4096;
+
+//hashes of counters first, first + 1, first + 2, first + 3 (lowbias32 by C. Wellons)
+static FORCEINLINE __m128i input_hash(uint32_t first) {
+  __m128i x = _mm_add_epi32(_mm_set1_epi32(int(first)), _mm_setr_epi32(0, 1, 2, 3));
+  x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+  x = mullo_epi32(x, _mm_set1_epi32(0x7FEB352D));
+  x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+  x = mullo_epi32(x, _mm_set1_epi32(int(0x846CA68BU)));
+  return _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+}
+
+//biased exponent field (not shifted) from random bits in lowest Bits bits of every lane
+template<int Bits>
+static FORCEINLINE __m128i input_exponent(__m128i h, int minExp, int maxExp, int bias) {
+  __m128i r = _mm_and_si128(h, _mm_set1_epi32((1 << Bits) - 1));
+  r = _mm_srli_epi32(mullo_epi32(r, _mm_set1_epi32(maxExp - minExp)), Bits);
+  return _mm_add_epi32(r, _mm_set1_epi32(minExp + bias));
+}
+
+//float: 23 upper bits of hash are mantissa, 9 lower bits select exponent
+static FORCEINLINE __m128i input_random_bits(const InputStream<float> &s, size_t index) {
+  __m128i h = input_hash(uint32_t(index) + s.seed * 0x9E3779B9U);
+  __m128i e = input_exponent<9>(h, s.minExp, s.maxExp, 127);
+  return _mm_or_si128(_mm_slli_epi32(e, 23), _mm_srli_epi32(h, 9));
+}
+//double takes two hashes (lanes are already paired): low one is lower half of mantissa,
+//20 upper bits of high one are the rest of mantissa, its 12 lower bits select exponent
+static FORCEINLINE __m128i input_random_bits(const InputStream<double> &s, size_t index) {
+  __m128i h = input_hash(uint32_t(2 * index) + s.seed * 0x9E3779B9U);
+  __m128i e = input_exponent<12>(h, s.minExp, s.maxExp, 1023);
+  __m128i high = _mm_or_si128(_mm_slli_epi32(e, 20), _mm_srli_epi32(h, 12));
+  __m128i mask = _mm_setr_epi32(0, -1, 0, -1);
+  return _mm_or_si128(_mm_and_si128(mask, high), _mm_andnot_si128(mask, h));
+}
+
+static FORCEINLINE __m128i input_enum_bits(float, size_t index) {
+  return _mm_add_epi32(_mm_set1_epi32(0x3F800000 + int(index)), _mm_setr_epi32(0, 1, 2, 3));
+}
+static FORCEINLINE __m128i input_enum_bits(double, size_t index) {
+  return _mm_add_epi64(_mm_set1_epi64x(0x3FF0000000000000LL + (long long)index), _mm_set_epi64x(1, 0));
+}
+
+//writes values with indices [first, first + count) of stream, all lying in the same part (enumerated or random)
+template<class T>
+static void generate_part(const InputStream<T> &s, T *out, size_t first, size_t count) {
+  const size_t W = sizeof(__m128i) / sizeof(T);
+  bool random = (first >= s.enumCount);
+  size_t i = 0;
+  for (; i + W <= count; i += W) {
+    __m128i bits = (random ? input_random_bits(s, first + i - s.enumCount) : input_enum_bits(T(), first + i));
+    _mm_storeu_si128((__m128i*)(out + i), bits);
+  }
+  if (i < count) {
+    T tmp[W];
+    __m128i bits = (random ? input_random_bits(s, first + i - s.enumCount) : input_enum_bits(T(), first + i));
+    _mm_storeu_si128((__m128i*)tmp, bits);
+    memcpy(out + i, tmp, (count - i) * sizeof(T));
+  }
+}
+
+//writes values with indices [first, first + count) of stream, indices wrap around the end of stream
+template<class T>
+static void generate_inputs(const InputStream<T> &s, T *out, size_t first, size_t count) {
+  while (count > 0) {
+    first %= s.size;
+    size_t end = (first < s.enumCount ? s.enumCount : s.size);
+    size_t len = (count < end - first ? count : end - first);
+    generate_part(s, out, first, len);
+    out += len;
+    first += len;
+    count -= len;
+  }
+}
+
+//calls func(block, first, len) for consecutive blocks of the whole stream, block holds values [first, first + len)
+template<class T, class Func>
+static void for_each_input_block(const InputStream<T> &s, Func func) {
+  std::vector<T, aligned_allocator<T, Alignment::AVX>> block(input_block_size);
+  for (size_t first = 0; first < s.size; first += input_block_size) {
+    size_t len = (s.size - first < input_block_size ? s.size - first : input_block_size);
+    generate_inputs(s, block.data(), first, len);
+    func((const T*)block.data(), first, len);
+  }
+}
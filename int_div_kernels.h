@@ -0,0 +1,232 @@
+#pragma once
+
+//Batch division of 32-bit integers by per-element divisors via floating-point reciprocal.
+//Quotient estimate trunc(n * recip(d)) is followed by exact correction in integers (or exact doubles),
+//so quotient and remainder are always the same as of scalar n / d and n % d (divisors must be nonzero).
+//
+//Float path: n, d and reciprocal have 24-bit mantissa, so one estimate is off by up to ~2^10 for large quotients.
+//Reciprocal is scaled down by (1 - 2^-20), so that estimates never exceed the quotient and the remainder stays nonnegative,
+//then the remainder is divided once more, and at most two final +1 corrections are needed.
+//Recip must have relative error below 2^-21.5 (e.g. recip_float4_nr1 or recip_float4_ieee, not raw rcpps).
+//Double path: n, d and q * d are exact in double, estimate with relative error below 2^-33 is off by at most one,
+//and it is fixed with one correction in each direction.
+//Recip must have relative error below 2^-33 (e.g. recip_double2_r3 or better).
+//
+//Signed division truncates towards zero, it is done on absolute values; INT_MIN / -1 wraps to INT_MIN.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "vector_traits.h"
+
+//vectors of 32-bit integer lanes for array drivers
+struct int32x4 {
+  typedef __m128i vec;
+  enum { width = 4 };
+  static FORCEINLINE vec loadu(const void *p) { return _mm_loadu_si128((const __m128i*)p); }
+  static FORCEINLINE void storeu(void *p, vec x) { _mm_storeu_si128((__m128i*)p, x); }
+};
+
+//unsigned 32-bit integers converted to float with one rounding: both 16-bit halves are exact
+static FORCEINLINE __m128 u32_to_float4(__m128i x) {
+  __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x, 16)), _mm_set1_ps(65536.0f));
+  return _mm_add_ps(hi, _mm_cvtepi32_ps(_mm_and_si128(x, _mm_set1_epi32(0xFFFF))));
+}
+//truncates float in [0, 2^32) to unsigned: values from 2^31 are shifted down before signed conversion
+static FORCEINLINE __m128i float4_to_u32(__m128 x) {
+  __m128 big = _mm_cmpge_ps(x, _mm_set1_ps(2147483648.0f));
+  __m128i res = _mm_cvttps_epi32(_mm_sub_ps(x, _mm_and_ps(big, _mm_set1_ps(2147483648.0f))));
+  return _mm_xor_si128(res, _mm_slli_epi32(_mm_castps_si128(big), 31));
+}
+//lanes 0, 1 (or 2, 3 with High) to double, exactly
+template<bool High>
+static FORCEINLINE __m128d u32_to_double2(__m128i x) {
+  x = _mm_xor_si128(x, _mm_set1_epi32(int(0x80000000U)));
+  __m128d res = _mm_cvtepi32_pd(High ? _mm_unpackhi_epi64(x, x) : x);
+  return _mm_add_pd(res, _mm_set1_pd(2147483648.0));
+}
+//truncates double in [0, 2^32) to unsigned in lanes 0, 1, the same way as float4_to_u32
+static FORCEINLINE __m128i double2_to_u32(__m128d x) {
+  __m128d big = _mm_cmpge_pd(x, _mm_set1_pd(2147483648.0));
+  __m128i res = _mm_cvttpd_epi32(_mm_sub_pd(x, _mm_and_pd(big, _mm_set1_pd(2147483648.0))));
+  __m128i bigLanes = _mm_shuffle_epi32(_mm_castpd_si128(big), _MM_SHUFFLE(3, 3, 2, 0));
+  return _mm_xor_si128(res, _mm_slli_epi32(_mm_and_si128(bigLanes, _mm_setr_epi32(-1, -1, 0, 0)), 31));
+}
+
+//r >= d as unsigned, all ones in lanes where true
+static FORCEINLINE __m128i cmpge_epu32(__m128i r, __m128i d) {
+  __m128i sign = _mm_set1_epi32(int(0x80000000U));
+  return _mm_andnot_si128(_mm_cmpgt_epi32(_mm_xor_si128(d, sign), _mm_xor_si128(r, sign)), _mm_set1_epi32(-1));
+}
+
+//canonical: quotient computed by _mm_div_pd is exact, because n / d never rounds up to the next integer
+//(distance to it is at least 1 / d, more than half ulp of quotient)
+static FORCEINLINE void udiv_u32x4_ieee(__m128i n, __m128i d, __m128i &q, __m128i &r) {
+  __m128d lo = _mm_div_pd(u32_to_double2<false>(n), u32_to_double2<false>(d));
+  __m128d hi = _mm_div_pd(u32_to_double2<true>(n), u32_to_double2<true>(d));
+  lo = _mm_min_pd(lo, _mm_set1_pd(4294967295.0));
+  hi = _mm_min_pd(hi, _mm_set1_pd(4294967295.0));
+  q = _mm_unpacklo_epi64(double2_to_u32(lo), double2_to_u32(hi));
+  r = _mm_sub_epi32(n, mullo_epi32(q, d));
+}
+
+template<__m128 (*Recip)(__m128)>
+static FORCEINLINE void udiv_u32x4_float(__m128i n, __m128i d, __m128i &q, __m128i &r) {
+  __m128 rcp = _mm_mul_ps(Recip(u32_to_float4(d)), _mm_set1_ps(1.0f - 1.0f / (1 << 20)));
+  q = float4_to_u32(_mm_mul_ps(u32_to_float4(n), rcp));
+  r = _mm_sub_epi32(n, mullo_epi32(q, d));
+  __m128i q2 = float4_to_u32(_mm_mul_ps(u32_to_float4(r), rcp));
+  q = _mm_add_epi32(q, q2);
+  r = _mm_sub_epi32(r, mullo_epi32(q2, d));
+  for (int k = 0; k < 2; k++) {
+    __m128i ge = cmpge_epu32(r, d);
+    q = _mm_sub_epi32(q, ge);
+    r = _mm_sub_epi32(r, _mm_and_si128(ge, d));
+  }
+}
+
+//two lanes in doubles: q * d is exact, so remainder is exact too
+template<__m128d (*Recip)(__m128d)>
+static FORCEINLINE __m128i udiv_double2_lanes(__m128d n, __m128d d) {
+  __m128d q = _mm_mul_pd(n, Recip(d));
+  q = _mm_min_pd(q, _mm_set1_pd(4294967295.0));
+  //truncation through integers (SSE2 has no roundpd)
+  q = u32_to_double2<false>(double2_to_u32(q));
+  __m128d r = _mm_sub_pd(n, _mm_mul_pd(q, d));
+  __m128d neg = _mm_cmplt_pd(r, _mm_setzero_pd());
+  q = _mm_sub_pd(q, _mm_and_pd(neg, _mm_set1_pd(1.0)));
+  r = _mm_add_pd(r, _mm_and_pd(neg, d));
+  __m128d ge = _mm_cmpge_pd(r, d);
+  q = _mm_add_pd(q, _mm_and_pd(ge, _mm_set1_pd(1.0)));
+  return double2_to_u32(q);
+}
+
+template<__m128d (*Recip)(__m128d)>
+static FORCEINLINE void udiv_u32x4_double(__m128i n, __m128i d, __m128i &q, __m128i &r) {
+  __m128i lo = udiv_double2_lanes<Recip>(u32_to_double2<false>(n), u32_to_double2<false>(d));
+  __m128i hi = udiv_double2_lanes<Recip>(u32_to_double2<true>(n), u32_to_double2<true>(d));
+  q = _mm_unpacklo_epi64(lo, hi);
+  r = _mm_sub_epi32(n, mullo_epi32(q, d));
+}
+
+//signed division by unsigned kernel on absolute values: quotient is negated when signs differ, remainder has sign of n
+template<void (*UDiv)(__m128i, __m128i, __m128i&, __m128i&)>
+static FORCEINLINE void sdiv_i32x4(__m128i n, __m128i d, __m128i &q, __m128i &r) {
+  __m128i sn = _mm_srai_epi32(n, 31), sd = _mm_srai_epi32(d, 31);
+  __m128i sq = _mm_xor_si128(sn, sd);
+  UDiv(_mm_sub_epi32(_mm_xor_si128(n, sn), sn), _mm_sub_epi32(_mm_xor_si128(d, sd), sd), q, r);
+  q = _mm_sub_epi32(_mm_xor_si128(q, sq), sq);
+  r = _mm_sub_epi32(_mm_xor_si128(r, sn), sn);
+}
+
+#ifdef __AVX2__
+struct int32x8 {
+  typedef __m256i vec;
+  enum { width = 8 };
+  static FORCEINLINE vec loadu(const void *p) { return _mm256_loadu_si256((const __m256i*)p); }
+  static FORCEINLINE void storeu(void *p, vec x) { _mm256_storeu_si256((__m256i*)p, x); }
+};
+
+static FORCEINLINE __m256 u32_to_float8(__m256i x) {
+  __m256 hi = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(x, 16)), _mm256_set1_ps(65536.0f));
+  return _mm256_add_ps(hi, _mm256_cvtepi32_ps(_mm256_and_si256(x, _mm256_set1_epi32(0xFFFF))));
+}
+static FORCEINLINE __m256i float8_to_u32(__m256 x) {
+  __m256 big = _mm256_cmp_ps(x, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ);
+  __m256i res = _mm256_cvttps_epi32(_mm256_sub_ps(x, _mm256_and_ps(big, _mm256_set1_ps(2147483648.0f))));
+  return _mm256_xor_si256(res, _mm256_slli_epi32(_mm256_castps_si256(big), 31));
+}
+static FORCEINLINE __m256d u32_to_double4(__m128i x) {
+  __m256d res = _mm256_cvtepi32_pd(_mm_xor_si128(x, _mm_set1_epi32(int(0x80000000U))));
+  return _mm256_add_pd(res, _mm256_set1_pd(2147483648.0));
+}
+static FORCEINLINE __m128i double4_to_u32(__m256d x) {
+  x = _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  __m128i res = _mm256_cvttpd_epi32(_mm256_sub_pd(x, _mm256_set1_pd(2147483648.0)));
+  return _mm_xor_si128(res, _mm_set1_epi32(int(0x80000000U)));
+}
+static FORCEINLINE __m256i cmpge_epu32(__m256i r, __m256i d) {
+  return _mm256_cmpeq_epi32(_mm256_max_epu32(r, d), r);
+}
+
+static FORCEINLINE void udiv_u32x8_ieee(__m256i n, __m256i d, __m256i &q, __m256i &r) {
+  __m128i nlo = _mm256_castsi256_si128(n), nhi = _mm256_extracti128_si256(n, 1);
+  __m128i dlo = _mm256_castsi256_si128(d), dhi = _mm256_extracti128_si256(d, 1);
+  __m256d lo = _mm256_min_pd(_mm256_div_pd(u32_to_double4(nlo), u32_to_double4(dlo)), _mm256_set1_pd(4294967295.0));
+  __m256d hi = _mm256_min_pd(_mm256_div_pd(u32_to_double4(nhi), u32_to_double4(dhi)), _mm256_set1_pd(4294967295.0));
+  q = _mm256_setr_m128i(double4_to_u32(lo), double4_to_u32(hi));
+  r = _mm256_sub_epi32(n, _mm256_mullo_epi32(q, d));
+}
+
+template<__m256 (*Recip)(__m256)>
+static FORCEINLINE void udiv_u32x8_float(__m256i n, __m256i d, __m256i &q, __m256i &r) {
+  __m256 rcp = _mm256_mul_ps(Recip(u32_to_float8(d)), _mm256_set1_ps(1.0f - 1.0f / (1 << 20)));
+  q = float8_to_u32(_mm256_mul_ps(u32_to_float8(n), rcp));
+  r = _mm256_sub_epi32(n, _mm256_mullo_epi32(q, d));
+  __m256i q2 = float8_to_u32(_mm256_mul_ps(u32_to_float8(r), rcp));
+  q = _mm256_add_epi32(q, q2);
+  r = _mm256_sub_epi32(r, _mm256_mullo_epi32(q2, d));
+  for (int k = 0; k < 2; k++) {
+    __m256i ge = cmpge_epu32(r, d);
+    q = _mm256_sub_epi32(q, ge);
+    r = _mm256_sub_epi32(r, _mm256_and_si256(ge, d));
+  }
+}
+
+template<__m256d (*Recip)(__m256d)>
+static FORCEINLINE __m128i udiv_double4_lanes(__m256d n, __m256d d) {
+  __m256d q = _mm256_mul_pd(n, Recip(d));
+  q = _mm256_round_pd(_mm256_min_pd(q, _mm256_set1_pd(4294967295.0)), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  __m256d r = _mm256_fnmadd_pd(q, d, n);
+  __m256d neg = _mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ);
+  q = _mm256_sub_pd(q, _mm256_and_pd(neg, _mm256_set1_pd(1.0)));
+  r = _mm256_add_pd(r, _mm256_and_pd(neg, d));
+  __m256d ge = _mm256_cmp_pd(r, d, _CMP_GE_OQ);
+  q = _mm256_add_pd(q, _mm256_and_pd(ge, _mm256_set1_pd(1.0)));
+  return double4_to_u32(q);
+}
+
+template<__m256d (*Recip)(__m256d)>
+static FORCEINLINE void udiv_u32x8_double(__m256i n, __m256i d, __m256i &q, __m256i &r) {
+  __m128i lo = udiv_double4_lanes<Recip>(u32_to_double4(_mm256_castsi256_si128(n)), u32_to_double4(_mm256_castsi256_si128(d)));
+  __m128i hi = udiv_double4_lanes<Recip>(u32_to_double4(_mm256_extracti128_si256(n, 1)), u32_to_double4(_mm256_extracti128_si256(d, 1)));
+  q = _mm256_setr_m128i(lo, hi);
+  r = _mm256_sub_epi32(n, _mm256_mullo_epi32(q, d));
+}
+
+template<void (*UDiv)(__m256i, __m256i, __m256i&, __m256i&)>
+static FORCEINLINE void sdiv_i32x8(__m256i n, __m256i d, __m256i &q, __m256i &r) {
+  __m256i sn = _mm256_srai_epi32(n, 31), sd = _mm256_srai_epi32(d, 31);
+  __m256i sq = _mm256_xor_si256(sn, sd);
+  UDiv(_mm256_abs_epi32(n), _mm256_abs_epi32(d), q, r);
+  q = _mm256_sub_epi32(_mm256_xor_si256(q, sq), sq);
+  r = _mm256_sub_epi32(_mm256_xor_si256(r, sn), sn);
+}
+#endif
+
+//q[i] = n[i] / d[i], r[i] = n[i] % d[i] for count elements (T is uint32_t or int32_t, as expected by Div),
+//arrays need not be aligned; tail is divided in buffer padded with 0 / 1
+template<class I, void (*Div)(typename I::vec, typename I::vec, typename I::vec&, typename I::vec&), class T>
+static void divide_array(T *q, T *r, const T *n, const T *d, size_t count) {
+  const size_t W = I::width;
+  typename I::vec vq, vr;
+  size_t i = 0;
+  for (; i + W <= count; i += W) {
+    Div(I::loadu(n + i), I::loadu(d + i), vq, vr);
+    I::storeu(q + i, vq);
+    I::storeu(r + i, vr);
+  }
+  if (i < count) {
+    T tn[W], td[W], tq[W], tr[W];
+    for (size_t j = 0; j < W; j++) {
+      tn[j] = (i + j < count ? n[i + j] : T(0));
+      td[j] = (i + j < count ? d[i + j] : T(1));
+    }
+    Div(I::loadu(tn), I::loadu(td), vq, vr);
+    I::storeu(tq, vq);
+    I::storeu(tr, vr);
+    for (size_t j = 0; j < count - i; j++) {
+      q[i + j] = tq[j];
+      r[i + j] = tr[j];
+    }
+  }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+//Inverse cube root a^(-1/3) (rcbrt), inverse fourth root a^(-1/4) (rqrt) and a^(-2/3) (rcbrt2) for positive normal inputs.
+//Rough seed is refined by relative correctors from corrector.h: r := 1 - a x^n, x := x (1 - r)^(-1/n),
+//the series of (1 - r)^(-1/n) is truncated to given order. Seed with relative error e gives r ~ n e,
+//and corrector of order N leaves error about a_N (n e)^N.
+//
+//Seeds:
+//  rcbrt: bit pattern of a^(-1/3) is approximately C - bits(a) / 3, since bit pattern is a scaled and shifted log2;
+//         C = 0x54A232A2 minimizes maximal relative error (3.4%). Bits are divided in float: rounding them
+//         to 24 bits changes seed by at most 2^-17 relative.
+//  rqrt:  rsqrt(a rsqrt(a)) with rsqrtps, relative error below 2^-11.
+//Double kernels take seed computed in float, so inputs must be within float range (like recip_double2_fast).
+//
+//Names: _fast is seed only, _r<N> adds corrector of order N, _r3r<N> adds cubic corrector and then corrector of order N
+//(cube root seed is too rough for a single step to reach full precision). rcbrt2 is square of rcbrt.
+//Baselines: _cbrt and _pow call libm for every lane, rqrt_*_ieee is 1 / sqrt(sqrt(a)).
+
+#include <cmath>
+#include "vector_traits.h"
+#include "corrector.h"
+
+//baseline: scalar function applied to every lane
+template<class V, typename V::elem (*Func)(typename V::elem)>
+static FORCEINLINE typename V::vec scalar_lanes(typename V::vec a) {
+  typename V::elem tmp[V::width];
+  V::storeu(tmp, a);
+  for (int i = 0; i < V::width; i++)
+    tmp[i] = Func(tmp[i]);
+  return V::loadu(tmp);
+}
+template<class T> static inline T rcbrt_libm_cbrt(T x) { return T(1) / std::cbrt(x); }
+template<class T> static inline T rqrt_libm_pow(T x) { return std::pow(x, T(-0.25)); }
+template<class T> static inline T rcbrt2_libm_pow(T x) { return std::pow(x, T(-2) / T(3)); }
+
+//a^(-2/3) from a^(-1/3) kernel
+template<class V, typename V::vec (*Rcbrt)(typename V::vec)>
+static FORCEINLINE typename V::vec rcbrt_squared(typename V::vec a) {
+  typename V::vec y = Rcbrt(a);
+  return V::mul(y, y);
+}
+
+//================ SSE2 ===============
+
+static FORCEINLINE __m128 rcbrt_float4_fast(__m128 a) {
+  __m128 third = _mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(a)), _mm_set1_ps(1.0f / 3.0f));
+  return _mm_castsi128_ps(_mm_sub_epi32(_mm_set1_epi32(0x54A232A2), _mm_cvttps_epi32(third)));
+}
+static FORCEINLINE __m128 rqrt_float4_fast(__m128 a) {
+  return _mm_rsqrt_ps(_mm_mul_ps(a, _mm_rsqrt_ps(a)));
+}
+static FORCEINLINE __m128d rcbrt_double2_fast(__m128d a) {
+  return _mm_cvtps_pd(rcbrt_float4_fast(_mm_cvtpd_ps(a)));
+}
+static FORCEINLINE __m128d rqrt_double2_fast(__m128d a) {
+  return _mm_cvtps_pd(rqrt_float4_fast(_mm_cvtpd_ps(a)));
+}
+
+template<int Order> static FORCEINLINE __m128 rcbrt_float4_r(__m128 a) {
+  return corrected<float4, rcbrt_float4_fast, CorrectorFunc::Rcbrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m128 rcbrt_float4_r3r(__m128 a) {
+  return corrected<float4, rcbrt_float4_r<3>, CorrectorFunc::Rcbrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m128 rqrt_float4_r(__m128 a) {
+  return corrected<float4, rqrt_float4_fast, CorrectorFunc::Rqrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m128d rcbrt_double2_r(__m128d a) {
+  return corrected<double2, rcbrt_double2_fast, CorrectorFunc::Rcbrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m128d rcbrt_double2_r3r(__m128d a) {
+  return corrected<double2, rcbrt_double2_r<3>, CorrectorFunc::Rcbrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m128d rqrt_double2_r(__m128d a) {
+  return corrected<double2, rqrt_double2_fast, CorrectorFunc::Rqrt, Order, PolyScheme::Horner>(a);
+}
+
+template<int Order> static FORCEINLINE __m128 rcbrt2_float4_r3r(__m128 a) {
+  return rcbrt_squared<float4, rcbrt_float4_r3r<Order>>(a);
+}
+template<int Order> static FORCEINLINE __m128d rcbrt2_double2_r3r(__m128d a) {
+  return rcbrt_squared<double2, rcbrt_double2_r3r<Order>>(a);
+}
+
+static FORCEINLINE __m128 rcbrt_float4_cbrt(__m128 a) { return scalar_lanes<float4, rcbrt_libm_cbrt<float>>(a); }
+static FORCEINLINE __m128 rqrt_float4_pow(__m128 a) { return scalar_lanes<float4, rqrt_libm_pow<float>>(a); }
+static FORCEINLINE __m128 rcbrt2_float4_pow(__m128 a) { return scalar_lanes<float4, rcbrt2_libm_pow<float>>(a); }
+static FORCEINLINE __m128d rcbrt_double2_cbrt(__m128d a) { return scalar_lanes<double2, rcbrt_libm_cbrt<double>>(a); }
+static FORCEINLINE __m128d rqrt_double2_pow(__m128d a) { return scalar_lanes<double2, rqrt_libm_pow<double>>(a); }
+static FORCEINLINE __m128d rcbrt2_double2_pow(__m128d a) { return scalar_lanes<double2, rcbrt2_libm_pow<double>>(a); }
+
+static FORCEINLINE __m128 rqrt_float4_ieee(__m128 a) {
+  return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_sqrt_ps(a)));
+}
+static FORCEINLINE __m128d rqrt_double2_ieee(__m128d a) {
+  return _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(_mm_sqrt_pd(a)));
+}
+
+//================ AVX2 ===============
+
+#ifdef __AVX2__
+static FORCEINLINE __m256 rcbrt_float8_fast(__m256 a) {
+  __m256 third = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(a)), _mm256_set1_ps(1.0f / 3.0f));
+  return _mm256_castsi256_ps(_mm256_sub_epi32(_mm256_set1_epi32(0x54A232A2), _mm256_cvttps_epi32(third)));
+}
+static FORCEINLINE __m256 rqrt_float8_fast(__m256 a) {
+  return _mm256_rsqrt_ps(_mm256_mul_ps(a, _mm256_rsqrt_ps(a)));
+}
+static FORCEINLINE __m256d rcbrt_double4_fast(__m256d a) {
+  return _mm256_cvtps_pd(rcbrt_float4_fast(_mm256_cvtpd_ps(a)));
+}
+static FORCEINLINE __m256d rqrt_double4_fast(__m256d a) {
+  return _mm256_cvtps_pd(rqrt_float4_fast(_mm256_cvtpd_ps(a)));
+}
+
+template<int Order> static FORCEINLINE __m256 rcbrt_float8_r(__m256 a) {
+  return corrected<float8, rcbrt_float8_fast, CorrectorFunc::Rcbrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m256 rcbrt_float8_r3r(__m256 a) {
+  return corrected<float8, rcbrt_float8_r<3>, CorrectorFunc::Rcbrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m256 rqrt_float8_r(__m256 a) {
+  return corrected<float8, rqrt_float8_fast, CorrectorFunc::Rqrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m256d rcbrt_double4_r(__m256d a) {
+  return corrected<double4, rcbrt_double4_fast, CorrectorFunc::Rcbrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m256d rcbrt_double4_r3r(__m256d a) {
+  return corrected<double4, rcbrt_double4_r<3>, CorrectorFunc::Rcbrt, Order, PolyScheme::Horner>(a);
+}
+template<int Order> static FORCEINLINE __m256d rqrt_double4_r(__m256d a) {
+  return corrected<double4, rqrt_double4_fast, CorrectorFunc::Rqrt, Order, PolyScheme::Horner>(a);
+}
+
+template<int Order> static FORCEINLINE __m256 rcbrt2_float8_r3r(__m256 a) {
+  return rcbrt_squared<float8, rcbrt_float8_r3r<Order>>(a);
+}
+template<int Order> static FORCEINLINE __m256d rcbrt2_double4_r3r(__m256d a) {
+  return rcbrt_squared<double4, rcbrt_double4_r3r<Order>>(a);
+}
+
+static FORCEINLINE __m256 rcbrt_float8_cbrt(__m256 a) { return scalar_lanes<float8, rcbrt_libm_cbrt<float>>(a); }
+static FORCEINLINE __m256 rqrt_float8_pow(__m256 a) { return scalar_lanes<float8, rqrt_libm_pow<float>>(a); }
+static FORCEINLINE __m256 rcbrt2_float8_pow(__m256 a) { return scalar_lanes<float8, rcbrt2_libm_pow<float>>(a); }
+static FORCEINLINE __m256d rcbrt_double4_cbrt(__m256d a) { return scalar_lanes<double4, rcbrt_libm_cbrt<double>>(a); }
+static FORCEINLINE __m256d rqrt_double4_pow(__m256d a) { return scalar_lanes<double4, rqrt_libm_pow<double>>(a); }
+static FORCEINLINE __m256d rcbrt2_double4_pow(__m256d a) { return scalar_lanes<double4, rcbrt2_libm_pow<double>>(a); }
+
+static FORCEINLINE __m256 rqrt_float8_ieee(__m256 a) {
+  return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(_mm256_sqrt_ps(a)));
+}
+static FORCEINLINE __m256d rqrt_double4_ieee(__m256d a) {
+  return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(_mm256_sqrt_pd(a)));
+}
+#endif
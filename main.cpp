@@ -1,235 +1,2267 @@
 #include <xmmintrin.h>
 #include <emmintrin.h>
-#include <intrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
 #include <vector>
 #include <random>
 #include <cassert>
 #include <algorithm>
 #include <cfloat>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <type_traits>
+#include <limits>
 #ifdef _MSC_VER
   #define noexcept
 #endif
 #include "aligned_allocator.h"
+#include "compiler.h"
 #include "rdtsc.h"
+#include "measure.h"
+#include "exhaustive.h"
+#include "reference.h"
+#include "vector_traits.h"
+#include "array_kernels.h"
+#include "corrector.h"
+#include "normalize.h"
+#include "narrow_kernels.h"
+#include "parallel_kernels.h"
+#include "input_generator.h"
+#include "int_div_kernels.h"
+#include "inverse_root_kernels.h"
+#include "recip_rsqrt.h"
+#include "autovec.h"
 using namespace std;
 
-#if defined(_MSC_VER)
-  #define FORCEINLINE __forceinline
-#elif defined(__GNUC__) || defined(__clang__)
-  #define FORCEINLINE __attribute__((always_inline))
-#endif
-
-typedef __m128 (*float4_func)(__m128);
-typedef __m128d (*double2_func)(__m128d);
-
 //================ Implementations ===============
 
 #include "routines_sse.h"
+#ifdef __AVX2__
+  #include "routines_avx.h"
+  #include "routines_table.h"
+#endif
+#include "correctly_rounded.h"
 
 
 //================ Testing for correctness ===============
 
-//taken from http://stackoverflow.com/a/31474088/556899
-template<class Vector> void enum_all_floats(Vector &res, float tmin, float tmax) {
-  for (float x = tmin; x < tmax; x = nextafterf(x, tmax))
-    res.push_back(x);
-  res.push_back(tmax);
+//test values are streamed by blocks (see input_generator.h): all floats in [1, 2] or 2^23 consecutive doubles from 1,
+//then random values with exponents in [-20, 20)
+const InputStream<float> test_stream_float = input_stream<float>((1<<23) + 1, 1<<25, -20, 20, 1);
+const InputStream<double> test_stream_double = input_stream<double>((1<<23) + 1, 1<<24, -20, 20, 2);
+//whole exponent range: results must be normal too, so both x and 1/x are within [2^-1021, 2^1021]
+const InputStream<double> test_stream_double_full = input_stream<double>(0, 1<<22, -1021, 1021, 3);
+
+static const InputStream<float> &get_test_stream(float) {
+  return test_stream_float;
+}
+static const InputStream<double> &get_test_stream(double) {
+  return test_stream_double;
 }
-template<class Vector> void enum_all_floats(Vector &res, double tmin, double tmax) {
-  for (double x = tmin; x < tmax; x = nextafter(x, tmax))
-    res.push_back(x);
-  res.push_back(tmax);
+
+//benchmarks on arrays need inputs in memory: they take random part of stream, materialized on first use
+const size_t test_values_count = 1<<20;
+template<class T> const vector<T, aligned_allocator<T, Alignment::AVX>> &get_test_values(T) {
+  static vector<T, aligned_allocator<T, Alignment::AVX>> values;
+  if (values.empty()) {
+    const InputStream<T> &s = get_test_stream(T());
+    values.resize(test_values_count);
+    generate_inputs(s, values.data(), s.enumCount, values.size());
+  }
+  return values;
 }
 
-vector<float, aligned_allocator<float, Alignment::AVX>> test_values_float;
-vector<double, aligned_allocator<float, Alignment::AVX>> test_values_double;
+template<class V> typename V::elem reduce_max(typename V::vec x) {
+  typename V::elem tmp[V::width];
+  V::storeu(tmp, x);
+  return *max_element(tmp, tmp + V::width);
+}
 
-float test_precision_float4(float4_func tested_func, float4_func correct_func) {
-  float *ptr = test_values_float.data();
-  size_t n = test_values_float.size();
+//precision of kernel against high-precision reference, all errors are in ULPs of result type
+const int ulp_buckets = 64;
+struct PrecisionStats {
+  double maxUlp, meanUlp, rmsUlp;
+  double maxRel;                    //maximal relative error
+  double correctlyRounded;          //fraction of results within half ulp of exact answer
+  double histogram[ulp_buckets];    //fraction of results with error in [0, 1/2], (1/2, 1], (1, 2], (2, 4], ...
+};
 
-  __m128 maxErr = _mm_setzero_ps();
-  for (size_t i = 0; i < n; i += 4) {
-    __m128 x = _mm_load_ps(&ptr[i]);
-    __m128 res = tested_func(x);
-    __m128 ans = correct_func(x);
-    __m128 diff = _mm_sub_ps(res, ans);
-    diff = _mm_max_ps(diff, _mm_sub_ps(_mm_setzero_ps(), diff));
-    __m128 relative = _mm_div_ps(diff, ans);
-    maxErr = _mm_max_ps(maxErr, relative);
-  }
+static int ulp_bucket(double err) {
+  if (err <= 0.5)
+    return 0;
+  if (!(err <= DBL_MAX))
+    return ulp_buckets - 1;
+  int e;
+  double m = frexp(err, &e);
+  int ceilLog = (m == 0.5 ? e - 1 : e);
+  return min(ceilLog + 1, ulp_buckets - 1);
+}
 
-  float tmp[4];
-  _mm_storeu_ps(tmp, maxErr);
-  return max(max(tmp[0], tmp[1]), max(tmp[2], tmp[3]));
+//prints upper bound of histogram bucket
+static void print_ulp_bucket(int k) {
+  if (k == 0)
+    printf("<=0.5");
+  else if (k == ulp_buckets - 1)
+    printf(">2^%d", k - 2);
+  else if (k - 1 <= 10)
+    printf("<=%d", 1 << (k - 1));
+  else
+    printf("<=2^%d", k - 1);
 }
 
-double test_precision_double2(double2_func tested_func, double2_func correct_func) {
-  double *ptr = test_values_double.data();
-  size_t n = test_values_double.size();
+//collects errors of results one by one
+class PrecisionAccumulator {
+public:
+  PrecisionAccumulator() : total(0), maxUlp(0.0), maxRel(0.0), sum(0.0), sumSq(0.0) {
+    for (int k = 0; k < ulp_buckets; k++)
+      counts[k] = 0;
+  }
+
+  template<class T> void add(T result, dd reference) {
+    double err = ulp_error(result, reference), rel = relative_error(result, reference);
+    if (!(err <= maxUlp))
+      maxUlp = err;
+    if (!(rel <= maxRel))
+      maxRel = rel;
+    sum += err;
+    sumSq += err * err;
+    counts[ulp_bucket(err)]++;
+    total++;
+  }
 
-  __m128d maxErr = _mm_setzero_pd();
-  for (size_t i = 0; i < n; i += 2) {
-    __m128d x = _mm_load_pd(&ptr[i]);
-    __m128d res = tested_func(x);
-    __m128d ans = correct_func(x);
-    __m128d diff = _mm_sub_pd(res, ans);
-    diff = _mm_max_pd(diff, _mm_sub_pd(_mm_setzero_pd(), diff));
-    __m128d relative = _mm_div_pd(diff, ans);
-    maxErr = _mm_max_pd(maxErr, relative);
+  PrecisionStats stats() const {
+    PrecisionStats st;
+    st.maxUlp = maxUlp;
+    st.meanUlp = sum / total;
+    st.rmsUlp = sqrt(sumSq / total);
+    st.maxRel = maxRel;
+    st.correctlyRounded = double(counts[0]) / total;
+    for (int k = 0; k < ulp_buckets; k++)
+      st.histogram[k] = double(counts[k]) / total;
+    return st;
   }
 
-  double tmp[2];
-  _mm_storeu_pd(tmp, maxErr);
-  return max(tmp[0], tmp[1]);
+private:
+  unsigned long long counts[ulp_buckets], total;
+  double maxUlp, maxRel, sum, sumSq;
+};
+
+template<class V, typename V::vec (*Func)(typename V::vec), dd (*Reference)(double)>
+PrecisionStats test_precision(const InputStream<typename V::elem> &inputs) {
+  typedef typename V::elem elem;
+  PrecisionAccumulator acc;
+  for_each_input_block(inputs, [&](const elem *ptr, size_t, size_t n) {
+    for (size_t i = 0; i < n; i += V::width) {
+      elem res[V::width];
+      V::storeu(res, Func(V::load(&ptr[i])));
+      for (size_t j = 0; j < V::width && i + j < n; j++)
+        acc.add(res[j], Reference(double(ptr[i + j])));
+    }
+  });
+  return acc.stats();
 }
 
-#define TEST_PRECISION(tested_func, correct_func, vec) {\
-  auto err = test_precision_##vec(tested_func, correct_func);\
-  printf("%s: maximal error = %g\n", #tested_func, err);\
+static void print_ulp_histogram(const PrecisionStats &prec) {
+  printf("    ulp histogram:");
+  for (int k = 0; k < ulp_buckets; k++) if (prec.histogram[k] > 0.0) {
+    printf("  ");
+    print_ulp_bucket(k);
+    printf(" %0.3g%%", prec.histogram[k] * 100.0);
+  }
+  printf("\n");
 }
 
 //================ Testing for performance ===============
 
-#define TEST_PERFORMANCE_float4(tested_func) {\
-  auto time_start = rdtsc();\
-  float *ptr = test_values_float.data();\
-  size_t n = test_values_float.size();\
-  __m128 checkSum = _mm_setzero_ps();\
-  for (size_t i = 0; i < n; i += 16) {\
-    __m128 x0 = _mm_load_ps(&ptr[i+0]);\
-    __m128 x1 = _mm_load_ps(&ptr[i+4]);\
-    __m128 x2 = _mm_load_ps(&ptr[i+8]);\
-    __m128 x3 = _mm_load_ps(&ptr[i+12]);\
-    x0 = tested_func(x0);\
-    x1 = tested_func(x1);\
-    x2 = tested_func(x2);\
-    x3 = tested_func(x3);\
-    x0 = tested_func(x0);\
-    x1 = tested_func(x1);\
-    x2 = tested_func(x2);\
-    x3 = tested_func(x3);\
-    x0 = tested_func(x0);\
-    x1 = tested_func(x1);\
-    x2 = tested_func(x2);\
-    x3 = tested_func(x3);\
-    x0 = tested_func(x0);\
-    x1 = tested_func(x1);\
-    x2 = tested_func(x2);\
-    x3 = tested_func(x3);\
-    __m128 r = _mm_add_ps(_mm_add_ps(x0, x1), _mm_add_ps(x2, x3));\
-    checkSum = _mm_add_ps(checkSum, r);\
-  }\
-  float tmp[4];\
-  _mm_storeu_ps(tmp, checkSum);\
-  float checkSumAll = tmp[0] + tmp[1] + tmp[2] + tmp[3];\
-  auto time_end = rdtsc();\
-  printf("%s: cycles per call = %0.2f   (%g)\n", #tested_func, double(time_end - time_start) / n, checkSumAll);\
-}
-
-#define TEST_PERFORMANCE_double2(tested_func) {\
-  auto time_start = rdtsc();\
-  double *ptr = test_values_double.data();\
-  size_t n = test_values_double.size();\
-  __m128d checkSum = _mm_setzero_pd();\
-  for (size_t i = 0; i < n; i += 8) {\
-    __m128d x0 = _mm_load_pd(&ptr[i+0]);\
-    __m128d x1 = _mm_load_pd(&ptr[i+2]);\
-    __m128d x2 = _mm_load_pd(&ptr[i+4]);\
-    __m128d x3 = _mm_load_pd(&ptr[i+6]);\
-    x0 = tested_func(x0);\
-    x1 = tested_func(x1);\
-    x2 = tested_func(x2);\
-    x3 = tested_func(x3);\
-    x0 = tested_func(x0);\
-    x1 = tested_func(x1);\
-    x2 = tested_func(x2);\
-    x3 = tested_func(x3);\
-    x0 = tested_func(x0);\
-    x1 = tested_func(x1);\
-    x2 = tested_func(x2);\
-    x3 = tested_func(x3);\
-    x0 = tested_func(x0);\
-    x1 = tested_func(x1);\
-    x2 = tested_func(x2);\
-    x3 = tested_func(x3);\
-    __m128d r = _mm_add_pd(_mm_add_pd(x0, x1), _mm_add_pd(x2, x3));\
-    checkSum = _mm_add_pd(checkSum, r);\
-  }\
-  double tmp[2];\
-  _mm_storeu_pd(tmp, checkSum);\
-  double checkSumAll = tmp[0] + tmp[1];\
-  auto time_end = rdtsc();\
-  printf("%s: cycles per call = %0.2f   (%g)\n", #tested_func, double(time_end - time_start) / (2*n), checkSumAll);\
-}
-
-#define TEST_PERFORMANCE(tested_func, vec) TEST_PERFORMANCE_##vec(tested_func)
-
-
-int main() {
-  //generate test values
-  mt19937 rnd;
-  uniform_real_distribution<float> distrf(-20.0f, 20.0f);
-  enum_all_floats(test_values_float, 1.0f, 2.0f);
-  for (size_t i = 0; i < (1<<25) || test_values_float.size() % 256 != 0; i++)
-    test_values_float.push_back(exp2f(distrf(rnd)));
-  uniform_real_distribution<double> distrd(-20.0, 20.0);
-  enum_all_floats(test_values_double, 1.0, 1.0 + DBL_EPSILON * (1<<23));
-  for (size_t i = 0; i < (1<<24) || test_values_double.size() % 256 != 0; i++)
-    test_values_double.push_back(exp2(distrd(rnd)));
-
-  //test reciprocal
-
-  TEST_PRECISION   (recip_float4_ieee, recip_float4_ieee, float4);
-  TEST_PERFORMANCE (recip_float4_ieee, float4);
-  TEST_PRECISION   (recip_float4_fast, recip_float4_ieee, float4);
-  TEST_PERFORMANCE (recip_float4_fast, float4);
-  TEST_PRECISION   (recip_float4_nr1, recip_float4_ieee, float4);
-  TEST_PERFORMANCE (recip_float4_nr1, float4);
-
-  TEST_PRECISION   (recip_double2_ieee, recip_double2_ieee, double2);
-  TEST_PERFORMANCE (recip_double2_ieee, double2);
-  TEST_PRECISION   (recip_double2_fast, recip_double2_ieee, double2);
-  TEST_PERFORMANCE (recip_double2_fast, double2);
-  TEST_PRECISION   (recip_double2_nr1, recip_double2_ieee, double2);
-  TEST_PERFORMANCE (recip_double2_nr1, double2);
-  TEST_PRECISION   (recip_double2_nr2, recip_double2_ieee, double2);
-  TEST_PERFORMANCE (recip_double2_nr2, double2);
-
-  TEST_PRECISION   (recip_double2_r3, recip_double2_ieee, double2);
-  TEST_PERFORMANCE (recip_double2_r3, double2);
-  TEST_PRECISION   (recip_double2_r4, recip_double2_ieee, double2);
-  TEST_PERFORMANCE (recip_double2_r4, double2);
-  TEST_PRECISION   (recip_double2_r5, recip_double2_ieee, double2);
-  TEST_PERFORMANCE (recip_double2_r5, double2);
-
-  //test reciprocal square root
-
-  TEST_PRECISION   (rsqrt_float4_ieee, rsqrt_float4_ieee, float4);
-  TEST_PERFORMANCE (rsqrt_float4_ieee, float4);
-  TEST_PRECISION   (rsqrt_float4_fast, rsqrt_float4_ieee, float4);
-  TEST_PERFORMANCE (rsqrt_float4_fast, float4);
-  TEST_PRECISION   (rsqrt_float4_nr1, rsqrt_float4_ieee, float4);
-  TEST_PERFORMANCE (rsqrt_float4_nr1, float4);
+//Each dependency chain repeatedly applies kernel to its own vector: x := f(x).
+//With one chain, time per call equals latency of the kernel.
+//With many independent chains, calls overlap, and time per call shows reciprocal throughput.
+template<int Chains> struct ChainStep {
+  template<class V, typename V::vec (*Func)(typename V::vec)>
+  static FORCEINLINE void apply(typename V::vec *x) {
+    ChainStep<Chains - 1>::template apply<V, Func>(x);
+    x[Chains - 1] = Func(x[Chains - 1]);
+  }
+};
+template<> struct ChainStep<0> {
+  template<class V, typename V::vec (*Func)(typename V::vec)>
+  static FORCEINLINE void apply(typename V::vec *) {}
+};
+
+volatile double checksum_sink;
+
+MeasureOptions measure_options = {1, 5, true};
+Timer *timer = 0;
+bool verbose = false;
+
+//returns cycles per call
+template<class V, typename V::vec (*Func)(typename V::vec), int Chains>
+Measurement measure_chains(size_t calls) {
+  typedef typename V::vec vec;
+  const auto &values = get_test_values(typename V::elem());
+  vec x[Chains];
+  for (int c = 0; c < Chains; c++)
+    x[c] = V::load(&values[c * 64]);
+
+  size_t steps = calls / Chains;
+  Measurement res = timer->measure([&]() {
+    vec y[Chains];
+    for (int c = 0; c < Chains; c++)
+      y[c] = x[c];
+    for (size_t i = 0; i < steps; i++)
+      ChainStep<Chains>::template apply<V, Func>(y);
+    for (int c = 0; c < Chains; c++)
+      x[c] = y[c];
+  }, double(steps * Chains));
+
+  vec sum = V::zero();
+  for (int c = 0; c < Chains; c++)
+    sum = V::add(sum, x[c]);
+  checksum_sink = reduce_max<V>(sum);
+  return res;
+}
+
+//numbers of independent chains to be measured (can be changed by --chains)
+const int chain_counts[] = {1, 2, 4, 8, 16};
+const int chain_counts_num = sizeof(chain_counts) / sizeof(chain_counts[0]);
+bool chain_counts_enabled[chain_counts_num] = {true, true, true, true, true};
+const size_t calls_per_measurement = 1<<20;
+
+//size in bytes of working set much larger than the last level cache
+static size_t memory_working_set() {
+  size_t cache = recip_rsqrt_cache_size(3);
+  return 4 * (cache > 0 ? cache : size_t(8) << 20);
+}
+
+template<class V, typename V::vec (*Func)(typename V::vec)>
+Measurement measure_chains(int chains) {
+  switch (chains) {
+    case 1: return measure_chains<V, Func, 1>(calls_per_measurement);
+    case 2: return measure_chains<V, Func, 2>(calls_per_measurement);
+    case 4: return measure_chains<V, Func, 4>(calls_per_measurement);
+    case 8: return measure_chains<V, Func, 8>(calls_per_measurement);
+    case 16: return measure_chains<V, Func, 16>(calls_per_measurement);
+  }
+  assert(false);
+  return Measurement();
+}
+
+void print_table_header() {
+  printf("%-28s %9s %8s %8s %7s", "kernel", "max ulp", "mean ulp", "rms ulp", "CR%");
+  for (int k = 0; k < chain_counts_num; k++) if (chain_counts_enabled[k]) {
+    if (chain_counts[k] == 1)
+      printf(" %8s", "latency");
+    else
+      printf(" %7dx", chain_counts[k]);
+  }
+  printf(" %10s %7s %7s %6s\n", "per elem", "insns", "uops", "dev%");
+}
+
+//error statistics and timings of one kernel in main tables
+struct KernelResult {
+  PrecisionStats prec;
+  Measurement chains[chain_counts_num];   //only for enabled chain counts
+  double perElem;                         //the best throughput in cycles per element
+  double instructions, uops;              //per call with most chains, negative if not available
+  double deviation;                       //the worst relative standard deviation
+};
+
+//measures median cycles per call for each number of chains
+template<class V, typename V::vec (*Func)(typename V::vec)>
+KernelResult measure_kernel(const PrecisionStats &prec) {
+  KernelResult res;
+  res.prec = prec;
+  double best = DBL_MAX, deviation = 0.0;
+  Measurement last = Measurement();
+  for (int k = 0; k < chain_counts_num; k++) if (chain_counts_enabled[k]) {
+    res.chains[k] = last = measure_chains<V, Func>(chain_counts[k]);
+    best = min(best, last.cycles.median);
+    deviation = max(deviation, last.cycles.stddev / last.cycles.median);
+  }
+  res.perElem = best / V::width;
+  res.instructions = last.instructions;
+  res.uops = last.uops;
+  res.deviation = deviation;
+  return res;
+}
+
+//prints row of table: error statistics in ULPs and percentage of correctly rounded results,
+//median cycles per call for each number of chains, the best throughput in cycles per element,
+//instructions and uops per call (with most chains), and the worst relative standard deviation
+//over all measurements; then prints histogram of errors
+void print_kernel_row(const char *name, const KernelResult &res) {
+  const PrecisionStats &prec = res.prec;
+  printf("%-28s %9.3g %8.3g %8.3g %7.3f", name, prec.maxUlp, prec.meanUlp, prec.rmsUlp, prec.correctlyRounded * 100.0);
+  for (int k = 0; k < chain_counts_num; k++) if (chain_counts_enabled[k])
+    printf(" %8.2f", res.chains[k].cycles.median);
+  printf(" %10.3f", res.perElem);
+  if (res.instructions >= 0.0)
+    printf(" %7.2f", res.instructions);
+  else
+    printf(" %7s", "-");
+  if (res.uops >= 0.0)
+    printf(" %7.2f", res.uops);
+  else
+    printf(" %7s", "-");
+  printf(" %6.1f\n", res.deviation * 100.0);
+
+  print_ulp_histogram(prec);
+
+  if (verbose) {
+    for (int k = 0; k < chain_counts_num; k++) if (chain_counts_enabled[k]) {
+      const Stats &st = res.chains[k].cycles;
+      printf("    %2d chains: min = %0.3f  median = %0.3f  mean = %0.3f  stddev = %0.3f\n",
+        chain_counts[k], st.min, st.median, st.mean, st.stddev);
+    }
+  }
+}
+
+template<class V, typename V::vec (*Func)(typename V::vec), dd (*Reference)(double)>
+KernelResult run_kernel() {
+  return measure_kernel<V, Func>(test_precision<V, Func, Reference>(get_test_stream(typename V::elem())));
+}
+
+//checks precision of double kernel on inputs from the whole exponent range
+template<class V, typename V::vec (*Func)(typename V::vec), dd (*Reference)(double)>
+void test_full_range(const char *name) {
+  PrecisionStats prec = test_precision<V, Func, Reference>(test_stream_double_full);
+  printf("%-28s %9.3g %8.3g %8.3g %7.3f\n", name, prec.maxUlp, prec.meanUlp, prec.rmsUlp, prec.correctlyRounded * 100.0);
+  print_ulp_histogram(prec);
+}
+
+#define TEST_FULL_RANGE(tested_func, function, vec) test_full_range<vec, tested_func, reference_##function>(#tested_func)
+
+//================ Division and square root ===============
+
+//precision of a / b: denominators are all test values, numerators are the same values shifted by half of stream
+template<class V, typename V::vec (*Div)(typename V::vec, typename V::vec)>
+PrecisionStats test_precision_div(const InputStream<typename V::elem> &inputs) {
+  typedef typename V::elem elem;
+  PrecisionAccumulator acc;
+  vector<elem, aligned_allocator<elem, Alignment::AVX>> num(input_block_size);
+  for_each_input_block(inputs, [&](const elem *den, size_t first, size_t n) {
+    generate_inputs(inputs, num.data(), first + inputs.size / 2, n);
+    for (size_t i = 0; i < n; i += V::width) {
+      elem res[V::width];
+      V::storeu(res, Div(V::load(&num[i]), V::load(&den[i])));
+      for (size_t k = 0; k < V::width && i + k < n; k++)
+        acc.add(res[k], reference_div(double(num[i + k]), double(den[i + k])));
+    }
+  });
+  return acc.stats();
+}
+
+//x := 3 / x, so that chain depends on denominator
+template<class V, typename V::vec (*Div)(typename V::vec, typename V::vec)>
+static FORCEINLINE typename V::vec divide_three(typename V::vec x) {
+  return Div(V::set1(typename V::elem(3)), x);
+}
+
+template<class V, typename V::vec (*Div)(typename V::vec, typename V::vec)>
+KernelResult run_div_kernel() {
+  return measure_kernel<V, divide_three<V, Div>>(test_precision_div<V, Div>(get_test_stream(typename V::elem())));
+}
+
+//same as run_kernel, and checks that sqrt(0) = 0
+template<class V, typename V::vec (*Func)(typename V::vec)>
+KernelResult run_sqrt_kernel() {
+  typename V::elem res[V::width];
+  V::storeu(res, Func(V::zero()));
+  if (res[0] != 0)
+    fprintf(stderr, "sqrt(0) = %g!\n", double(res[0]));
+  return run_kernel<V, Func, reference_sqrt>();
+}
+
+//================ Kernel registry ===============
+
+//Kernels of the main tables (recip, rsqrt, div/sqrt, rcbrt/rqrt) are registered with their properties,
+//then filtered by command line and run. Each entry points to test loops instantiated for its kernel and reference,
+//so nothing is called indirectly inside the loops.
+
+//instruction set needed by vector type
+static const char *vector_isa(__m128) { return "sse2"; }
+static const char *vector_isa(__m128d) { return "sse2"; }
+static const char *vector_isa(double2x2::vec) { return "sse2"; }
+#ifdef __AVX2__
+static const char *vector_isa(__m256) { return "avx2"; }
+static const char *vector_isa(__m256d) { return "avx2"; }
+#endif
+
+struct KernelEntry {
+  string name;
+  const char *table;      //main table which kernel belongs to
+  const char *function;   //recip, rsqrt, div, sqrt, rcbrt, rqrt or rcbrt2
+  const char *type;       //element type
+  int width;
+  const char *isa;
+  KernelResult (*run)();
+};
+
+vector<KernelEntry> kernel_registry;
+const char *registry_table = "";    //table of kernels being registered
+
+template<class V> void register_kernel(const string &name, const char *function, KernelResult (*run)()) {
+  KernelEntry e = {name, registry_table, function, is_same<typename V::elem, float>::value ? "float" : "double",
+    V::width, vector_isa(typename V::vec()), run};
+  kernel_registry.push_back(e);
+}
+
+#define REGISTER_KERNEL(tested_func, function, vec) \
+  register_kernel<vec>(#tested_func, #function, run_kernel<vec, tested_func, reference_##function>)
+#define REGISTER_DIV(tested_func, vec) register_kernel<vec>(#tested_func, "div", run_div_kernel<vec, tested_func>)
+#define REGISTER_SQRT(tested_func, vec) register_kernel<vec>(#tested_func, "sqrt", run_sqrt_kernel<vec, tested_func>)
+
+//command line filters: comma-separated substrings of kernel name (any of them must match) and instruction set
+string kernel_name_filter, kernel_isa_filter;
+
+static bool kernel_selected(const KernelEntry &e) {
+  if (!kernel_isa_filter.empty() && kernel_isa_filter != e.isa)
+    return false;
+  if (kernel_name_filter.empty())
+    return true;
+  size_t pos = 0;
+  while (pos <= kernel_name_filter.size()) {
+    size_t end = kernel_name_filter.find(',', pos);
+    if (end == string::npos)
+      end = kernel_name_filter.size();
+    if (end > pos && e.name.find(kernel_name_filter.substr(pos, end - pos)) != string::npos)
+      return true;
+    pos = end + 1;
+  }
+  return false;
+}
+
+//================ Results output ===============
+
+enum class OutputFormat { Text, Json, Csv };
+OutputFormat output_format = OutputFormat::Text;
+
+//JSON has no infinity and NaN
+static void print_json_number(double x) {
+  if (x == x && x <= DBL_MAX && x >= -DBL_MAX)
+    printf("%.6g", x);
+  else
+    printf("null");
+}
+
+void print_csv_header() {
+  printf("name,function,type,width,isa,max_ulp,mean_ulp,rms_ulp,max_rel,cr_percent");
+  for (int k = 0; k < chain_counts_num; k++) if (chain_counts_enabled[k])
+    printf(",cycles_%dx", chain_counts[k]);
+  printf(",per_elem,insns,uops,dev_percent\n");
+}
+
+void print_csv_row(const KernelEntry &e, const KernelResult &res) {
+  const PrecisionStats &prec = res.prec;
+  printf("%s,%s,%s,%d,%s,%.6g,%.6g,%.6g,%.6g,%.4f", e.name.c_str(), e.function, e.type, e.width, e.isa,
+    prec.maxUlp, prec.meanUlp, prec.rmsUlp, prec.maxRel, prec.correctlyRounded * 100.0);
+  for (int k = 0; k < chain_counts_num; k++) if (chain_counts_enabled[k])
+    printf(",%.4f", res.chains[k].cycles.median);
+  printf(",%.4f,", res.perElem);
+  if (res.instructions >= 0.0)
+    printf("%.4f", res.instructions);
+  printf(",");
+  if (res.uops >= 0.0)
+    printf("%.4f", res.uops);
+  printf(",%.2f\n", res.deviation * 100.0);
+}
+
+void print_json_row(const KernelEntry &e, const KernelResult &res, bool first) {
+  const PrecisionStats &prec = res.prec;
+  printf("%s\n  {\"name\": \"%s\", \"function\": \"%s\", \"type\": \"%s\", \"width\": %d, \"isa\": \"%s\",\n",
+    first ? "" : ",", e.name.c_str(), e.function, e.type, e.width, e.isa);
+  printf("   \"max_ulp\": ");
+  print_json_number(prec.maxUlp);
+  printf(", \"mean_ulp\": ");
+  print_json_number(prec.meanUlp);
+  printf(", \"rms_ulp\": ");
+  print_json_number(prec.rmsUlp);
+  printf(", \"max_rel\": ");
+  print_json_number(prec.maxRel);
+  printf(", \"cr_percent\": %.4f,\n   \"ulp_histogram\": [", prec.correctlyRounded * 100.0);
+  for (int k = 0; k < ulp_buckets; k++)
+    printf(k ? ", %.6g" : "%.6g", prec.histogram[k]);
+  printf("],\n   \"cycles\": {");
+  bool firstChain = true;
+  for (int k = 0; k < chain_counts_num; k++) if (chain_counts_enabled[k]) {
+    printf("%s\"%d\": %.4f", firstChain ? "" : ", ", chain_counts[k], res.chains[k].cycles.median);
+    firstChain = false;
+  }
+  printf("}, \"per_elem\": %.4f, \"insns\": ", res.perElem);
+  print_json_number(res.instructions >= 0.0 ? res.instructions : NAN);
+  printf(", \"uops\": ");
+  print_json_number(res.uops >= 0.0 ? res.uops : NAN);
+  printf(", \"dev_percent\": %.2f}", res.deviation * 100.0);
+}
+
+//row of baseline file written with --format=csv
+struct BaselineRow {
+  string name;
+  double maxUlp, perElem;
+};
+
+//reads name, max_ulp and per_elem columns of csv file
+bool load_baseline(const char *path, vector<BaselineRow> &rows) {
+  FILE *file = fopen(path, "r");
+  if (!file)
+    return false;
+  int nameCol = -1, ulpCol = -1, elemCol = -1;
+  char line[4096];
+  bool header = true;
+  while (fgets(line, sizeof(line), file)) {
+    vector<string> cols;
+    string cell;
+    for (const char *p = line; *p && *p != '\n' && *p != '\r'; p++) {
+      if (*p == ',') {
+        cols.push_back(cell);
+        cell.clear();
+      }
+      else
+        cell += *p;
+    }
+    cols.push_back(cell);
+    if (header) {
+      for (int c = 0; c < int(cols.size()); c++) {
+        if (cols[c] == "name") nameCol = c;
+        if (cols[c] == "max_ulp") ulpCol = c;
+        if (cols[c] == "per_elem") elemCol = c;
+      }
+      header = false;
+      continue;
+    }
+    if (nameCol < 0 || ulpCol < 0 || elemCol < 0)
+      break;
+    if (int(cols.size()) <= max(nameCol, max(ulpCol, elemCol)))
+      continue;
+    BaselineRow row = {cols[nameCol], atof(cols[ulpCol].c_str()), atof(cols[elemCol].c_str())};
+    rows.push_back(row);
+  }
+  fclose(file);
+  return nameCol >= 0 && ulpCol >= 0 && elemCol >= 0;
+}
+
+//compare mode: kernel regresses if it is slower than baseline by more than tolerance (in percent),
+//or if its max error grew at all; report goes to stderr when results are machine-readable
+double regression_tolerance = 10.0;
+
+int compare_with_baseline(const vector<BaselineRow> &baseline, const vector<pair<const KernelEntry*, KernelResult>> &results) {
+  FILE *out = (output_format == OutputFormat::Text ? stdout : stderr);
+  int regressions = 0, matched = 0;
+  fprintf(out, "\nComparison with baseline (tolerance %g%% on cycles per element):\n", regression_tolerance);
+  for (size_t i = 0; i < results.size(); i++) {
+    const KernelEntry &e = *results[i].first;
+    const KernelResult &res = results[i].second;
+    size_t b = 0;
+    while (b < baseline.size() && baseline[b].name != e.name)
+      b++;
+    if (b == baseline.size())
+      continue;
+    matched++;
+    const BaselineRow &base = baseline[b];
+    bool slower = (res.perElem > base.perElem * (1.0 + regression_tolerance / 100.0));
+    bool lessPrecise = !(res.prec.maxUlp <= base.maxUlp * (1.0 + 1e-5));
+    if (slower)
+      fprintf(out, "  REGRESSION %-28s cycles per element %.3f -> %.3f (%+.1f%%)\n", e.name.c_str(),
+        base.perElem, res.perElem, (res.perElem / base.perElem - 1.0) * 100.0);
+    if (lessPrecise)
+      fprintf(out, "  REGRESSION %-28s max ulp %.6g -> %.6g\n", e.name.c_str(), base.maxUlp, res.prec.maxUlp);
+    regressions += (slower || lessPrecise);
+  }
+  fprintf(out, "  %d of %d kernels found in baseline, %d regressed\n", matched, int(results.size()), regressions);
+  return regressions;
+}
+
+//runs selected kernels of registry and prints their results, text tables are split by registry_table;
+//returns number of regressions against baseline (if given)
+int run_registered_kernels(const vector<BaselineRow> *baseline) {
+  vector<pair<const KernelEntry*, KernelResult>> results;
+  const char *table = 0;
+  if (output_format == OutputFormat::Csv)
+    print_csv_header();
+  if (output_format == OutputFormat::Json)
+    printf("[");
+  for (size_t i = 0; i < kernel_registry.size(); i++) {
+    const KernelEntry &e = kernel_registry[i];
+    if (!kernel_selected(e))
+      continue;
+    if (output_format == OutputFormat::Text && (!table || strcmp(table, e.table) != 0)) {
+      if (table)
+        printf("\n");
+      print_table_header();
+      table = e.table;
+    }
+    KernelResult res = e.run();
+    if (output_format == OutputFormat::Text)
+      print_kernel_row(e.name.c_str(), res);
+    else if (output_format == OutputFormat::Csv)
+      print_csv_row(e, res);
+    else
+      print_json_row(e, res, results.empty());
+    fflush(stdout);
+    results.push_back(make_pair(&e, res));
+  }
+  if (output_format == OutputFormat::Json)
+    printf("\n]\n");
+  return baseline ? compare_with_baseline(*baseline, results) : 0;
+}
+
+//================ Special values ===============
+
+//edge cases: signed zeros, infinities, NaN, negative numbers, subnormals and extremes of normal range,
+//and inputs around bounds of direct kernel calls in safe variants (2^+-62 for recip, 2^+-126 for rsqrt)
+template<class T> vector<T> special_inputs() {
+  typedef numeric_limits<T> L;
+  T values[] = {
+    T(0), -T(0), L::infinity(), -L::infinity(), L::quiet_NaN(), T(-1), T(-0.3), -L::max(),
+    L::denorm_min(), 3 * L::denorm_min(), L::min() / 2, L::min() * T(0.6), -L::min() / 2,
+    L::min(), L::max(), L::max() / 3, T(1), T(3),
+    ldexp(T(1), 100), ldexp(T(1), -100), -ldexp(T(1), 100), ldexp(T(1), 126), ldexp(T(1), -126),
+    ldexp(T(16777215), 102), T(1) / L::min(), ldexp(T(3), 61), ldexp(T(3), -64),
+  };
+  return vector<T>(values, values + sizeof(values) / sizeof(values[0]));
+}
+
+static long double ieee_recip(long double x) { return 1.0L / x; }
+static long double ieee_rsqrt(long double x) { return 1.0L / sqrtl(x); }
+
+//NaN, infinities and zeros must match exactly (with sign), finite results must have relative error below maxRel
+//(plus one ulp, since subnormal results have lower relative precision)
+template<class T> bool special_matches(T res, T expected, double maxRel) {
+  if (std::isnan(expected))
+    return std::isnan(res);
+  if (std::isinf(expected) || expected == 0)
+    return memcmp(&res, &expected, sizeof(T)) == 0;
+  return fabs(double(res) - double(expected)) <= maxRel * fabs(double(expected)) + ulp_of<T>(double(expected));
+}
+
+//number of special inputs where kernel differs from IEEE result, mismatches are printed if verbose
+template<class V, typename V::vec (*Func)(typename V::vec)>
+int count_special_mismatches(const char *name, long double (*ieee)(long double), double maxRel) {
+  typedef typename V::elem elem;
+  vector<elem> in = special_inputs<elem>();
+  int mismatches = 0;
+  for (size_t i = 0; i < in.size(); i += V::width) {
+    size_t k = min(in.size() - i, size_t(V::width));
+    elem res[V::width];
+    V::storeu(res, Func(V::load_partial(&in[i], k)));
+    for (size_t j = 0; j < k; j++) {
+      elem expected = elem(ieee(in[i + j]));
+      if (!special_matches(res[j], expected, maxRel)) {
+        mismatches++;
+        if (verbose)
+          printf("    %s(%g) = %g, expected %g\n", name, double(in[i + j]), double(res[j]), double(expected));
+      }
+    }
+  }
+  return mismatches;
+}
+
+//sets or clears FTZ (flush-to-zero for results) and DAZ (denormals-are-zero for inputs) in MXCSR
+static void set_ftz_daz(bool on) {
+  unsigned flags = _MM_FLUSH_ZERO_ON | _MM_DENORMALS_ZERO_ON;
+  _mm_setcsr(on ? _mm_getcsr() | flags : _mm_getcsr() & ~flags);
+}
+
+//inputs for measurements on arrays in L1 cache
+const size_t special_array_size = 4096;
+//every fourth input is zero, so that safe variants take the path with fix-ups in every vector
+template<class T> vector<T, aligned_allocator<T, Alignment::AVX>> zeros_array() {
+  vector<T, aligned_allocator<T, Alignment::AVX>> res(special_array_size);
+  for (size_t i = 0; i < res.size(); i++)
+    res[i] = (i % 4 == 0 ? T(0) : T(1) + T(i) / T(res.size()));
+  return res;
+}
+//half of inputs are subnormal and half are huge (so that recip has subnormal results)
+template<class T> vector<T, aligned_allocator<T, Alignment::AVX>> subnormals_array() {
+  typedef numeric_limits<T> L;
+  vector<T, aligned_allocator<T, Alignment::AVX>> res(special_array_size);
+  for (size_t i = 0; i < res.size(); i++)
+    res[i] = (i % 2 ? L::max() / T(1 + i) : L::denorm_min() * T(1 + i));
+  return res;
+}
+
+//cycles per element of apply_array, with FTZ and DAZ on or off
+template<class V, typename V::vec (*Func)(typename V::vec), class Array>
+double measure_array(const Array &in, bool ftzDaz) {
+  Array out(in.size());
+  set_ftz_daz(ftzDaz);
+  Measurement m = timer->measure([&]() {
+    apply_array<V, Func>(out.data(), in.data(), in.size());
+  }, double(in.size()));
+  set_ftz_daz(false);
+  checksum_sink = double(out[in.size() / 2]);
+  return m.cycles.median;
+}
+
+//latency with the fewest chains enabled and cycles per element with the most chains
+template<class V, typename V::vec (*Func)(typename V::vec)>
+void measure_latency_throughput(double &latency, double &perElem) {
+  int first = -1, last = -1;
+  for (int k = 0; k < chain_counts_num; k++) if (chain_counts_enabled[k]) {
+    if (first < 0)
+      first = k;
+    last = k;
+  }
+  latency = measure_chains<V, Func>(chain_counts[first]).cycles.median;
+  perElem = measure_chains<V, Func>(chain_counts[last]).cycles.median / V::width;
+}
+
+//compares kernel with its safe variant: mismatches on special inputs, cost of safety in cycles
+//(when all inputs are in range, and when every vector needs fix-ups),
+//and cycles per element on subnormal / huge inputs with FTZ and DAZ off and on
+template<class V, typename V::vec (*Func)(typename V::vec), typename V::vec (*Safe)(typename V::vec)>
+void test_special(const char *name, long double (*ieee)(long double), double maxRel) {
+  typedef typename V::elem elem;
+  int fails = count_special_mismatches<V, Func>(name, ieee, maxRel);
+  int safeFails = count_special_mismatches<V, Safe>((string(name) + "_safe").c_str(), ieee, maxRel);
+  double latency, perElem, safeLatency, safePerElem;
+  measure_latency_throughput<V, Func>(latency, perElem);
+  measure_latency_throughput<V, Safe>(safeLatency, safePerElem);
+  auto subnormals = subnormals_array<elem>();
+  printf("%-28s %3d /%3d  %6.2f /%6.2f  %6.3f /%6.3f /%6.3f  %7.3f /%7.3f  %7.3f /%7.3f\n", name,
+    fails, safeFails, latency, safeLatency, perElem, safePerElem, measure_array<V, Safe>(zeros_array<elem>(), false),
+    measure_array<V, Func>(subnormals, false), measure_array<V, Func>(subnormals, true),
+    measure_array<V, Safe>(subnormals, false), measure_array<V, Safe>(subnormals, true));
+}
+
+//function is recip or rsqrt, safe variant is <function>_<vec>_safe<tested_func>
+#define TEST_SPECIAL(tested_func, function, vec, maxRel) \
+  test_special<vec, tested_func, function##_##vec##_safe<tested_func>>(#tested_func, ieee_##function, maxRel)
+
+//================ Narrow floats ===============
+
+//value of 16-bit float with mantBits stored mantissa bits (10 for fp16, 7 for bf16)
+static double narrow_value(uint16_t bits, int mantBits) {
+  int expBits = 15 - mantBits, bias = (1 << (expBits - 1)) - 1;
+  int e = (bits >> mantBits) & ((1 << expBits) - 1), m = bits & ((1 << mantBits) - 1);
+  double sign = (bits & 0x8000 ? -1.0 : 1.0);
+  if (e == (1 << expBits) - 1)
+    return m ? NAN : sign * INFINITY;
+  return sign * ldexp(double(e ? m + (1 << mantBits) : m), (e ? e : 1) - bias - mantBits);
+}
+
+//x rounded to nearest even value of the same format, overflow gives infinity
+static double narrow_round(long double x, int mantBits) {
+  int expBits = 15 - mantBits, bias = (1 << (expBits - 1)) - 1;
+  if (std::isnan(x) || std::isinf(x) || x == 0)
+    return double(x);
+  int e;
+  frexpl(fabsl(x), &e);
+  long double ulp = ldexpl(1.0L, max(e - 1, 1 - bias) - mantBits);
+  long double res = nearbyintl(x / ulp) * ulp;
+  long double maxValue = ldexpl((1 << (mantBits + 1)) - 1, bias - mantBits);
+  return double(fabsl(res) > maxValue ? copysignl(INFINITY, x) : res);
+}
+
+static bool same_value(double a, double b) {
+  return (std::isnan(a) && std::isnan(b)) || (a == b && std::signbit(a) == std::signbit(b));
+}
+
+//runs apply_narrow on all 65536 inputs (in ragged chunks, so that tails are checked too);
+//on normal inputs with normal answer: max error in ulps of format against exact answer and percentage of correctly rounded results,
+//on other inputs: number of results different from correctly rounded ones
+template<template<class> class Format, class V, typename V::vec (*Func)(typename V::vec)>
+void narrow_precision(long double (*ieee)(long double), double &maxUlp, double &crPercent, int &edgeFails) {
+  const int mantBits = Format<V>::mantissa_bits, minExp = 2 - (1 << (14 - mantBits));
+  vector<uint16_t> in(1 << 16), out(1 << 16);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = uint16_t(i);
+  for (size_t i = 0; i < in.size(); i += 1001)
+    apply_narrow<Format, V, Func>(&out[i], &in[i], min(in.size() - i, size_t(1001)));
+
+  maxUlp = 0.0;
+  edgeFails = 0;
+  int normals = 0, correct = 0;
+  auto normal = [&](double v) { return std::isfinite(v) && fabs(v) >= ldexp(1.0, minExp); };
+  for (size_t i = 0; i < in.size(); i++) {
+    double x = narrow_value(in[i], mantBits), res = narrow_value(out[i], mantBits);
+    long double exact = ieee(x);
+    double expected = narrow_round(exact, mantBits);
+    if (normal(x) && normal(expected)) {
+      int e;
+      frexpl(fabsl(exact), &e);
+      maxUlp = max(maxUlp, double(fabsl(res - exact) / ldexpl(1.0L, e - 1 - mantBits)));
+      normals++;
+      correct += same_value(res, expected);
+    }
+    else if (!same_value(res, expected)) {
+      edgeFails++;
+      if (verbose)
+        printf("    %g -> %g, expected %g\n", x, res, expected);
+    }
+  }
+  crPercent = 100.0 * correct / normals;
+}
+
+//sizes of arrays: in L1 cache, and much larger than the last level cache (float input and output take memory_working_set)
+const size_t narrow_l1_size = 4096;
+static size_t narrow_memory_size() {
+  return memory_working_set() / (2 * sizeof(float));
+}
+
+//random positive values from [2^-12, 2^12] (uniformly distributed bit patterns), so that results are normal in both formats
+static vector<uint16_t> narrow_test_values(int mantBits, size_t n) {
+  int bias = (1 << (14 - mantBits)) - 1;
+  mt19937 rnd(mantBits);
+  uniform_int_distribution<int> distr((bias - 12) << mantBits, (bias + 12) << mantBits);
+  vector<uint16_t> res(n);
+  for (size_t i = 0; i < n; i++)
+    res[i] = uint16_t(distr(rnd));
+  return res;
+}
+
+template<template<class> class Format, class V, typename V::vec (*Func)(typename V::vec)>
+double measure_narrow(const vector<uint16_t> &in) {
+  vector<uint16_t> out(in.size());
+  Measurement m = timer->measure([&]() {
+    apply_narrow<Format, V, Func>(out.data(), in.data(), in.size());
+  }, double(in.size()));
+  checksum_sink = double(out[in.size() / 2]);
+  return m.cycles.median;
+}
+
+//precision on all inputs and cycles per element of apply_narrow on arrays in L1 cache and in memory
+template<template<class> class Format, class V, typename V::vec (*Func)(typename V::vec)>
+void test_narrow(const char *name, const char *format, long double (*ieee)(long double)) {
+  const int mantBits = Format<V>::mantissa_bits;
+  double maxUlp, crPercent;
+  int edgeFails;
+  narrow_precision<Format, V, Func>(ieee, maxUlp, crPercent, edgeFails);
+  printf("%-22s %-5s %8.3f %8.3f %6d %9.3f %9.3f\n", name, format, maxUlp, crPercent, edgeFails,
+    measure_narrow<Format, V, Func>(narrow_test_values(mantBits, narrow_l1_size)),
+    measure_narrow<Format, V, Func>(narrow_test_values(mantBits, narrow_memory_size())));
+}
+
+//the same values converted to float, processed by apply_array
+template<class V, typename V::vec (*Func)(typename V::vec)>
+void test_narrow_float(const char *name) {
+  vector<float, aligned_allocator<float, Alignment::AVX>> l1(narrow_l1_size), memory(narrow_memory_size());
+  vector<uint16_t> values = narrow_test_values(10, narrow_memory_size());
+  for (size_t i = 0; i < memory.size(); i++)
+    memory[i] = float(narrow_value(values[i], 10));
+  copy(memory.begin(), memory.begin() + l1.size(), l1.begin());
+  printf("%-22s %-5s %8s %8s %6s %9.3f %9.3f\n", name, "float", "-", "-", "-",
+    measure_array<V, Func>(l1, false), measure_array<V, Func>(memory, false));
+}
+
+//format is Half or BFloat16
+#define TEST_NARROW(tested_func, function, vec, format) \
+  test_narrow<format, vec, tested_func>(#tested_func, format<vec>::mantissa_bits == 10 ? "fp16" : "bf16", ieee_##function)
+#define TEST_NARROW_FLOAT(tested_func, vec) test_narrow_float<vec, tested_func>(#tested_func)
+
+//================ Correct rounding ===============
+
+//Kernels of correctly_rounded.h are verified by exact comparison with midpoints (is_correctly_rounded_*),
+//since double-double reference cannot decide the hardest cases. Hard cases are inputs whose result is extremely close
+//to a midpoint or to a double, scaled by even powers of two (so that structure is kept for rsqrt):
+//  1/a for a = 1 - k 2^-53 is 1 + k 2^-53 + k^2 2^-106 + ..., just above a midpoint for odd k;
+//  1/sqrt(a) for a = 1 - k 2^-52 is 1 + k 2^-53 + 3/2 k^2 2^-106 + ..., just above a midpoint for odd k;
+//  a = 1 + k 2^-52 gives results just above doubles: rounding is easy, but approximation must be faithful.
+//Random test values cover the rest.
+
+static vector<double> hard_rounding_cases() {
+  const int scales[] = {-64, -2, 0, 2, 64};
+  vector<double> res;
+  for (int scale : scales)
+    for (int k = 1; k <= 4096; k++) {
+      res.push_back(ldexp(1.0 - ldexp(double(k), -53), scale));
+      res.push_back(ldexp(1.0 - ldexp(double(k), -52), scale));
+      res.push_back(ldexp(1.0 + ldexp(double(k), -52), scale));
+      res.push_back(ldexp(2.0 - ldexp(double(k), -51), scale));
+    }
+  return res;
+}
+
+//counts incorrectly rounded results
+template<class V, typename V::vec (*Func)(typename V::vec)>
+size_t count_misrounded(const double *values, size_t count, bool (*correct)(double, double), PrecisionAccumulator &acc, dd (*reference)(double)) {
+  size_t wrong = 0;
+  for (size_t i = 0; i < count; i += V::width) {
+    double res[V::width];
+    V::storeu(res, Func(V::loadu(&values[i])));
+    for (size_t k = 0; k < V::width; k++) {
+      wrong += !correct(values[i + k], res[k]);
+      acc.add(res[k], reference(values[i + k]));
+    }
+  }
+  return wrong;
+}
+
+template<class V, typename V::vec (*Func)(typename V::vec)>
+void test_correct_rounding(const char *name, bool (*correct)(double, double), dd (*reference)(double)) {
+  static const vector<double> hard = hard_rounding_cases();
+  const auto &random = get_test_values(double());
+  PrecisionAccumulator acc;
+  size_t hardWrong = count_misrounded<V, Func>(hard.data(), hard.size(), correct, acc, reference);
+  size_t randomWrong = count_misrounded<V, Func>(random.data(), random.size(), correct, acc, reference);
+  printf("%-28s %10zu/%-7zu %10zu/%-7zu %8.3g\n", name, hardWrong, hard.size(), randomWrong, random.size(), acc.stats().maxUlp);
+}
+
+#define TEST_CORRECT_ROUNDING(tested_func, function, vec) \
+  test_correct_rounding<vec, tested_func>(#tested_func, is_correctly_rounded_##function, reference_##function)
+
+//================ Integer division ===============
+
+//Kernels of int_div_kernels.h are checked against scalar / and % on structured cases:
+//all pairs of small numbers, edge divisors (powers of two and their neighbours, small odd numbers, the largest values, random ones)
+//with numerators near multiples k * d and near the ends of range, and random pairs with log-uniform magnitudes.
+//Signed kernels get every case with all four combinations of signs.
+
+typedef void (*u32_divider)(uint32_t *q, uint32_t *r, const uint32_t *n, const uint32_t *d, size_t count);
+typedef void (*i32_divider)(int32_t *q, int32_t *r, const int32_t *n, const int32_t *d, size_t count);
+
+template<class T> void divide_scalar(T *q, T *r, const T *n, const T *d, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    q[i] = n[i] / d[i];
+    r[i] = n[i] % d[i];
+  }
+}
+
+//collects cases into block, checks whole block with array kernel
+template<class T> class IntDivChecker {
+public:
+  IntDivChecker(void (*divide)(T*, T*, const T*, const T*, size_t)) : checked(0), mismatches(0), badN(0), badD(0), divide(divide) {}
+
+  //unsigned cases are reinterpreted as signed ones, with all signs
+  void add(uint32_t a, uint32_t b) {
+    if (is_signed<T>::value) {
+      T sa = T(a), sb = T(b);
+      push(sa, sb);
+      push(T(0U - uint32_t(sa)), sb);
+      push(sa, T(0U - uint32_t(sb)));
+      push(T(0U - uint32_t(sa)), T(0U - uint32_t(sb)));
+    }
+    else
+      push(T(a), T(b));
+  }
+
+  void flush() {
+    size_t count = n.size();
+    vector<T> q(count), r(count);
+    divide(q.data(), r.data(), n.data(), d.data(), count);
+    for (size_t i = 0; i < count; i++) if (q[i] != n[i] / d[i] || r[i] != n[i] % d[i]) {
+      if (mismatches == 0) {
+        badN = n[i];
+        badD = d[i];
+      }
+      mismatches++;
+    }
+    checked += count;
+    n.clear();
+    d.clear();
+  }
+
+  unsigned long long checked, mismatches;
+  T badN, badD;    //first mismatch
+
+private:
+  void push(T a, T b) {
+    //division by zero and overflow of INT_MIN / -1 are undefined in scalar code
+    if (b == 0 || (is_signed<T>::value && b == T(-1) && a == numeric_limits<T>::min()))
+      return;
+    n.push_back(a);
+    d.push_back(b);
+    if (n.size() == 4096)
+      flush();
+  }
+
+  void (*divide)(T*, T*, const T*, const T*, size_t);
+  vector<T> n, d;
+};
+
+//number with random bit length, so that magnitudes are log-uniform
+static uint32_t random_magnitude(mt19937 &rnd) {
+  uint32_t bits = rnd() % 33;
+  return bits == 0 ? 0 : uint32_t(rnd()) >> (32 - bits);
+}
+
+template<class T> void int_div_cases(IntDivChecker<T> &checker) {
+  const uint32_t grid = (is_signed<T>::value ? 1024 : 2048);
+  for (uint32_t a = 0; a < grid; a++)
+    for (uint32_t b = 1; b < grid; b++)
+      checker.add(a, b);
+
+  mt19937 rnd(22);
+  vector<uint32_t> divisors = {3, 5, 7, 10, 100, 1000, 65535, 65537, 0x7FFFFFFFU, 0x80000001U, 0xFFFFFFFEU, 0xFFFFFFFFU};
+  for (int e = 0; e < 32; e++) {
+    divisors.push_back((1U << e) - 1);
+    divisors.push_back(1U << e);
+    divisors.push_back((1U << e) + 1);
+  }
+  for (int k = 0; k < 1024; k++)
+    divisors.push_back(random_magnitude(rnd));
+  const uint32_t ends[] = {0, 1, 2, 0x7FFFFFFEU, 0x7FFFFFFFU, 0x80000000U, 0x80000001U, 0xFFFFFFFEU, 0xFFFFFFFFU};
+  for (size_t i = 0; i < divisors.size(); i++) {
+    uint32_t b = divisors[i];
+    if (b == 0)
+      continue;
+    for (size_t j = 0; j < sizeof(ends) / sizeof(ends[0]); j++)
+      checker.add(ends[j], b);
+    //multiples k * b with the largest k, neighbours of 2^31 / b, and random k
+    uint32_t kmax = 0xFFFFFFFFU / b;
+    uint32_t ks[68] = {1, 2, kmax, kmax - 1, 0x7FFFFFFFU / b, 0x7FFFFFFFU / b + 1};
+    for (int k = 6; k < 68; k++)
+      ks[k] = (kmax > 0 ? uint32_t(rnd()) % kmax + 1 : 1);
+    for (int k = 0; k < 68; k++) if (ks[k] >= 1 && ks[k] <= kmax) {
+      uint32_t m = ks[k] * b;
+      checker.add(m - 1, b);
+      checker.add(m, b);
+      if (m + 1 != 0)
+        checker.add(m + 1, b);
+    }
+  }
+
+  for (int k = 0; k < (1 << 22); k++)
+    checker.add(random_magnitude(rnd), random_magnitude(rnd));
+  checker.flush();
+}
+
+//returns cycles per element on arrays of 4096 pairs (in L1 cache) with random numerators and log-uniform divisors
+template<class T> double measure_int_div(void (*divide)(T*, T*, const T*, const T*, size_t)) {
+  const size_t count = 4096, passes = 16;
+  vector<T> n(count), d(count), q(count), r(count);
+  mt19937 rnd(220);
+  for (size_t i = 0; i < count; i++) {
+    n[i] = T(uint32_t(rnd()));
+    do
+      d[i] = T(random_magnitude(rnd) ^ (rnd() & 0x80000000U & (is_signed<T>::value ? ~0U : 0U)));
+    while (d[i] == 0 || (is_signed<T>::value && d[i] == T(-1)));
+  }
+  Measurement m = timer->measure([&]() {
+    for (size_t p = 0; p < passes; p++)
+      divide(q.data(), r.data(), n.data(), d.data(), count);
+  }, double(count * passes));
+  checksum_sink = double(q[count / 2] + r[count / 3]);
+  return m.cycles.median;
+}
+
+template<class T> void test_int_div(const char *name, void (*divide)(T*, T*, const T*, const T*, size_t)) {
+  IntDivChecker<T> checker(divide);
+  int_div_cases(checker);
+  printf("%-52s %-6s %10llu %10llu %9.3f", name, is_signed<T>::value ? "int32" : "uint32",
+    checker.checked, checker.mismatches, measure_int_div(divide));
+  if (checker.mismatches > 0)
+    printf("  first: %lld / %lld", (long long)checker.badN, (long long)checker.badD);
+  printf("\n");
+}
+
+//e.g. TEST_INT_DIV(udiv_u32x4_float<recip_float4_nr1>, int32x4, uint32_t)
+#define TEST_INT_DIV(div_func, ivec, type) test_int_div<type>(#div_func, divide_array<ivec, div_func, type>)
+#define TEST_INT_DIV_SCALAR(type) test_int_div<type>("scalar div", divide_scalar<type>)
+
+//================ Generated correctors ===============
+
+//registers corrected<...> kernels of all orders in [Order, MaxOrder] on seed Seed,
+//with Horner scheme, and with Estrin scheme when it differs (from order 4),
+//then the same order with minimax coefficients (corrected_minimax<...> with Horner scheme)
+template<class V, typename V::vec (*Seed)(typename V::vec), CorrectorFunc Func, int Order, int MaxOrder, dd (*Reference)(double)>
+void register_correctors(const string &, const char *, false_type) {}
+
+template<class V, typename V::vec (*Seed)(typename V::vec), CorrectorFunc Func, int Order, int MaxOrder, dd (*Reference)(double)>
+void register_correctors(const string &prefix, const char *function, true_type) {
+  string name = prefix + "_gen" + to_string(Order);
+  register_kernel<V>(name + "_horner", function, run_kernel<V, corrected<V, Seed, Func, Order, PolyScheme::Horner>, Reference>);
+  if (Order >= 4)
+    register_kernel<V>(name + "_estrin", function, run_kernel<V, corrected<V, Seed, Func, Order, PolyScheme::Estrin>, Reference>);
+  register_kernel<V>(prefix + "_minimax" + to_string(Order), function, run_kernel<V, corrected_minimax<V, Seed, Func, Order, PolyScheme::Horner>, Reference>);
+  register_correctors<V, Seed, Func, Order + 1, MaxOrder, Reference>(prefix, function, integral_constant<bool, (Order < MaxOrder)>());
+}
+
+//e.g. REGISTER_CORRECTORS(recip, Recip, double2, 6) registers recip_double2_gen2_horner ... recip_double2_minimax6
+#define REGISTER_CORRECTORS(function, Function, vec, maxOrder) \
+  register_correctors<vec, function##_##vec##_fast, CorrectorFunc::Function, 2, maxOrder, reference_##function>(#function "_" #vec, #function, true_type())
+
+//================ Testing normalization ===============
+
+typedef void (*soa_normalizer)(float *const *comps, size_t n);
+typedef void (*aos_normalizer)(float *out, const float *in, size_t n);
+
+//scalar reference: one 1/sqrt per vector
+template<int Dim> void normalize_soa_scalar(float *const *comps, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    float dot = 0.0f;
+    for (int k = 0; k < Dim; k++)
+      dot += comps[k][i] * comps[k][i];
+    float scale = (dot > 0.0f ? 1.0f / sqrtf(dot) : 0.0f);
+    for (int k = 0; k < Dim; k++)
+      comps[k][i] *= scale;
+  }
+}
+template<int Dim> void normalize_aos_scalar(float *out, const float *in, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    float dot = 0.0f;
+    for (int k = 0; k < Dim; k++)
+      dot += in[i * Dim + k] * in[i * Dim + k];
+    float scale = (dot > 0.0f ? 1.0f / sqrtf(dot) : 0.0f);
+    for (int k = 0; k < Dim; k++)
+      out[i * Dim + k] = in[i * Dim + k] * scale;
+  }
+}
+
+const size_t normalize_count = 4099;    //not divisible by vector width, so that tails are checked
+const int normalize_passes = 16;
+
+//random vectors in AoS layout, every 17th of them is zero
+template<int Dim> vector<float> normalize_test_vectors() {
+  mt19937 rnd(Dim);
+  uniform_real_distribution<float> distr(-10.0f, 10.0f);
+  vector<float> res(normalize_count * Dim);
+  for (size_t i = 0; i < normalize_count; i++)
+    for (int k = 0; k < Dim; k++)
+      res[i * Dim + k] = (i % 17 == 0 ? 0.0f : distr(rnd));
+  return res;
+}
+
+//prints max absolute error of components (against normalization in double),
+//number of zero vectors which did not stay zero, and cycles per vector
+template<int Dim> void print_normalize_row(const char *name, const vector<float> &in, const vector<float> &out, const Measurement &m) {
+  double maxErr = 0.0;
+  size_t zeroFails = 0;
+  for (size_t i = 0; i < normalize_count; i++) {
+    double dot = 0.0;
+    for (int k = 0; k < Dim; k++)
+      dot += double(in[i * Dim + k]) * in[i * Dim + k];
+    for (int k = 0; k < Dim; k++) {
+      if (dot == 0.0)
+        zeroFails += (out[i * Dim + k] != 0.0f);
+      else
+        maxErr = max(maxErr, fabs(out[i * Dim + k] - in[i * Dim + k] / sqrt(dot)));
+    }
+  }
+  printf("%-36s %10.3g %6d %10.2f\n", name, maxErr, int(zeroFails), m.cycles.median);
+}
+
+template<int Dim> void test_normalize_soa(const char *name, soa_normalizer func) {
+  vector<float> in = normalize_test_vectors<Dim>(), out(in.size());
+  vector<float, aligned_allocator<float, Alignment::AVX>> comps[Dim];
+  float *ptrs[Dim];
+  for (int k = 0; k < Dim; k++) {
+    for (size_t i = 0; i < normalize_count; i++)
+      comps[k].push_back(in[i * Dim + k]);
+    ptrs[k] = comps[k].data();
+  }
+  func(ptrs, normalize_count);
+  for (size_t i = 0; i < normalize_count; i++)
+    for (int k = 0; k < Dim; k++)
+      out[i * Dim + k] = comps[k][i];
+
+  //in-place, so normalized vectors are normalized again
+  Measurement m = timer->measure([&]() {
+    for (int p = 0; p < normalize_passes; p++)
+      func(ptrs, normalize_count);
+  }, double(normalize_count * normalize_passes));
+  print_normalize_row<Dim>(name, in, out, m);
+}
+
+template<int Dim> void test_normalize_aos(const char *name, aos_normalizer func) {
+  vector<float> in = normalize_test_vectors<Dim>(), out(in.size());
+  func(out.data(), in.data(), normalize_count);
+  Measurement m = timer->measure([&]() {
+    for (int p = 0; p < normalize_passes; p++)
+      func(out.data(), in.data(), normalize_count);
+  }, double(normalize_count * normalize_passes));
+  print_normalize_row<Dim>(name, in, out, m);
+}
+
+//e.g. TEST_NORMALIZE(aos, 3, float4, rsqrt_float4_nr1) tests normalize_aos<float4, rsqrt_float4_nr1, 3>
+#define TEST_NORMALIZE(layout, dim, vec, rsqrt_func) \
+  test_normalize_##layout<dim>("normalize" #dim "_" #layout " " #rsqrt_func, normalize_##layout<vec, rsqrt_func, dim>)
+#define TEST_NORMALIZE_SCALAR(layout, dim) \
+  test_normalize_##layout<dim>("normalize" #dim "_" #layout " scalar", normalize_##layout##_scalar<dim>)
+
+//================ Exhaustive testing of float kernels ===============
+
+static float float_from_bits(uint32_t bits) {
+  float res;
+  memcpy(&res, &bits, sizeof(res));
+  return res;
+}
+
+uint32_t exhaustive_first = 0, exhaustive_last = 0xFFFFFFFFU;
+int threads_num = max(int(thread::hardware_concurrency()), 1);
+
+template<class V, typename V::vec (*Func)(typename V::vec), typename V::vec (*Correct)(typename V::vec)>
+void test_exhaustive(const char *name) {
+  auto time_start = chrono::steady_clock::now();
+  ExhaustiveResult res = test_exhaustive<V, Func, Correct>(exhaustive_first, exhaustive_last, threads_num);
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - time_start).count();
+
+  printf("%s: maximal error = %g at %g (0x%08X)", name,
+    res.maxError, float_from_bits(res.maxErrorInput), res.maxErrorInput);
+  printf(", on normals = %g at %g (0x%08X)",
+    res.maxNormalError, float_from_bits(res.maxNormalErrorInput), res.maxNormalErrorInput);
+  printf(", special mismatches = %llu", res.mismatches);
+  if (res.mismatches > 0)
+    printf(" (first at %g (0x%08X))", float_from_bits(res.mismatchInput), res.mismatchInput);
+  printf("   [%0.1f s]\n", seconds);
+}
+
+#define TEST_EXHAUSTIVE(tested_func, correct_func, vec) test_exhaustive<vec, tested_func, correct_func>(#tested_func)
+
+//================ Testing array drivers ===============
+
+//runs apply_array on consecutive chunks of ragged sizes with misaligned input and output,
+//both out-of-place and in-place, and checks results against kernel applied to aligned vectors
+template<class V, typename V::vec (*Func)(typename V::vec)>
+void test_array(const char *name, const typename V::elem *ptr, size_t n) {
+  typedef typename V::elem elem;
+  vector<elem, aligned_allocator<elem, Alignment::AVX>> ref(n), buf(n + 64);
+  for (size_t i = 0; i + V::width <= n; i += V::width)
+    V::store(&ref[i], Func(V::load(&ptr[i])));
+  size_t sizes[] = {1, 7, 61, 1000, 4097, 100003, n - 5};
+  size_t mismatches = 0;
+
+  printf("%s: cycles per element on ragged arrays:", name);
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    size_t len = sizes[s], shift = s % 3 + 1;
+    size_t m = n - n % len;
+    elem *out = &buf[shift];
+    const elem *in = &ptr[0];
+
+    auto time_start = rdtsc_begin();
+    for (size_t i = 0; i < m; i += len)
+      apply_array<V, Func>(out + i, in + i, len);
+    auto time_end = rdtsc_end();
+    printf("  [%d] %0.3f", int(len), double(time_end - time_start) / m);
+    for (size_t i = 0; i < m; i++)
+      mismatches += (memcmp(&out[i], &ref[i], sizeof(elem)) != 0);
+
+    copy(in, in + m, out);
+    for (size_t i = 0; i < m; i += len)
+      apply_array<V, Func>(out + i, out + i, len);
+    for (size_t i = 0; i < m; i++)
+      mismatches += (memcmp(&out[i], &ref[i], sizeof(elem)) != 0);
+
+    if (len >= n / 2) {
+      time_start = rdtsc_begin();
+      apply_array<V, Func>(out, in, len, 0);
+      time_end = rdtsc_end();
+      printf(" (streaming %0.3f)", double(time_end - time_start) / len);
+      for (size_t i = 0; i < len; i++)
+        mismatches += (memcmp(&out[i], &ref[i], sizeof(elem)) != 0);
+    }
+  }
+  printf("\n");
+  if (mismatches > 0)
+    printf("%s: %d elements mismatch!\n", name, int(mismatches));
+}
+
+#define TEST_ARRAY(tested_func, vec) \
+  test_array<vec, tested_func>(#tested_func, get_test_values(vec::elem()).data(), test_values_count)
+
+//================ Testing dispatched library calls ===============
+
+//compares bulk function from recip_rsqrt.h with direct inlined calls of a kernel
+//on blocks of different size (small blocks show overhead of dispatching)
+template<class V, typename V::vec (*Func)(typename V::vec)>
+void test_dispatch(const char *name, void (*bulk_func)(typename V::elem*, const typename V::elem*, size_t, PrecisionTier), PrecisionTier tier, const typename V::elem *ptr, size_t n) {
+  typedef typename V::elem elem;
+  vector<elem, aligned_allocator<elem, Alignment::AVX>> out(n);
+  size_t blocks[] = {16, 1024, n};
+
+  printf("%s: cycles per element (direct / dispatched to %s):", name, recip_rsqrt_isa());
+  for (size_t b = 0; b < 3; b++) {
+    size_t block = blocks[b];
+    auto time_start = rdtsc_begin();
+    for (size_t i = 0; i + block <= n; i += block)
+      apply_array<V, Func>(&out[i], &ptr[i], block, recip_rsqrt_streaming_threshold());
+    auto time_mid = rdtsc_end();
+    for (size_t i = 0; i + block <= n; i += block)
+      bulk_func(&out[i], &ptr[i], block, tier);
+    auto time_end = rdtsc_end();
+    printf("  [%d] %0.3f / %0.3f", int(block), double(time_mid - time_start) / n, double(time_end - time_mid) / n);
+  }
+  printf("\n");
+}
+
+#define TEST_DISPATCH(tested_func, bulk_func, tier, vec) \
+  test_dispatch<vec, tested_func>(#tested_func, bulk_func, PrecisionTier::tier, get_test_values(vec::elem()).data(), test_values_count)
+
+
+//================ Working set sweep ===============
+
+//Every kernel streams over arrays which fit into L1, L2, L3 cache, or are much larger than L3 (input and output together).
+//Each loaded vector goes through kernel Depth times before it is stored, so depth sets computation per byte of traffic.
+//A cheaper approximation helps only while the loop is bound by computation rather than by bandwidth.
+
+//numbers of kernel calls per loaded vector (can be changed by --depth)
+const int sweep_depths[] = {1, 2, 4, 8};
+const int sweep_depths_num = sizeof(sweep_depths) / sizeof(sweep_depths[0]);
+bool sweep_depths_enabled[sweep_depths_num] = {true, true, true, true};
+
+const int sweep_levels_num = 4;
+const char *const sweep_level_names[sweep_levels_num] = {"L1", "L2", "L3", "DRAM"};
+size_t sweep_bytes[sweep_levels_num];     //input + output
+//small working sets are passed over several times in one run
+const size_t sweep_elements_per_run = 1 << 22;
+
+//half of each cache level, so that stack and other data fit too
+static void init_sweep_sizes() {
+  size_t defaults[3] = {size_t(32) << 10, size_t(1) << 20, size_t(8) << 20};
+  for (int l = 0; l < 3; l++) {
+    size_t cache = recip_rsqrt_cache_size(l + 1);
+    sweep_bytes[l] = (cache > 0 ? cache : defaults[l]) / 2;
+  }
+  sweep_bytes[3] = memory_working_set();
+}
+
+//kernel applied Depth times: x := f(f(...f(x)))
+template<class V, typename V::vec (*Func)(typename V::vec), int Depth>
+static FORCEINLINE typename V::vec repeated(typename V::vec x) {
+  for (int k = 0; k < Depth; k++)
+    x = Func(x);
+  return x;
+}
+
+//arrays for the largest working set, input is filled with test values
+template<class T> vector<T, aligned_allocator<T, Alignment::AVX>> &sweep_array(bool input) {
+  static vector<T, aligned_allocator<T, Alignment::AVX>> arrays[2];
+  auto &res = arrays[input];
+  if (res.empty()) {
+    res.resize(sweep_bytes[sweep_levels_num - 1] / (2 * sizeof(T)));
+    const auto &values = get_test_values(T());
+    for (size_t i = 0; i < res.size(); i++)
+      res[i] = (input ? values[i % values.size()] : T(0));
+  }
+  return res;
+}
+
+template<class V, typename V::vec (*Func)(typename V::vec)>
+Measurement measure_sweep(size_t n, size_t passes) {
+  typedef typename V::elem elem;
+  elem *out = sweep_array<elem>(false).data();
+  const elem *in = sweep_array<elem>(true).data();
+  Measurement m = timer->measure([&]() {
+    for (size_t p = 0; p < passes; p++)
+      apply_array<V, Func>(out, in, n);
+  }, double(n * passes));
+  checksum_sink = double(out[n / 2]);
+  return m;
+}
+
+template<class V, typename V::vec (*Func)(typename V::vec)>
+Measurement measure_sweep(int depth, size_t n, size_t passes) {
+  switch (depth) {
+    case 1: return measure_sweep<V, repeated<V, Func, 1>>(n, passes);
+    case 2: return measure_sweep<V, repeated<V, Func, 2>>(n, passes);
+    case 4: return measure_sweep<V, repeated<V, Func, 4>>(n, passes);
+    case 8: return measure_sweep<V, repeated<V, Func, 8>>(n, passes);
+  }
+  assert(false);
+  return Measurement();
+}
+
+void print_sweep_header() {
+  printf("working sets (input + output):");
+  for (int l = 0; l < sweep_levels_num; l++)
+    printf("  %s %0.0f KB", sweep_level_names[l], sweep_bytes[l] / 1024.0);
+  printf("\n\n%-28s %5s", "kernel", "depth");
+  for (int l = 0; l < sweep_levels_num; l++)
+    printf(" %9s %7s", (string(sweep_level_names[l]) + " c/elem").c_str(), "GB/s");
+  printf("\n");
+}
+
+//one row per depth: cycles per element and bandwidth (bytes loaded and stored per second) for each working set
+template<class V, typename V::vec (*Func)(typename V::vec)>
+void test_sweep(const char *name) {
+  typedef typename V::elem elem;
+  for (int d = 0; d < sweep_depths_num; d++) if (sweep_depths_enabled[d]) {
+    printf("%-28s %5d", name, sweep_depths[d]);
+    for (int l = 0; l < sweep_levels_num; l++) {
+      size_t n = sweep_bytes[l] / (2 * sizeof(elem));
+      n -= n % V::width;
+      size_t passes = max(sweep_elements_per_run / n, size_t(1));
+      Measurement m = measure_sweep<V, Func>(sweep_depths[d], n, passes);
+      printf(" %9.3f %7.1f", m.cycles.median, 2.0 * sizeof(elem) * n * passes / m.seconds * 1e-9);
+    }
+    printf("\n");
+  }
+}
+
+#define TEST_SWEEP(tested_func, vec) test_sweep<vec, tested_func>(#tested_func)
+
+//================ Multithreaded scaling ===============
+
+//Throughput of parallel_apply_array on arrays much larger than the last level cache (memory_working_set in total)
+//with 1, 2, 4, ... threads up to --threads=N. Arrays are allocated for every pool and placed by first touch of its threads,
+//output is written with non-temporal stores (threshold of the library).
+
+template<class T> using FirstTouchArray = vector<T, FirstTouchAllocator<T>>;
+
+//pools of all measured sizes, workers are pinned
+vector<ThreadPool*> scaling_pools;
+
+static void init_scaling_pools() {
+  for (int t = 1; ; t = min(2 * t, threads_num)) {
+    scaling_pools.push_back(new ThreadPool(t, true));
+    if (t == threads_num)
+      break;
+  }
+}
+
+//returns bandwidth in GB/s (bytes loaded and stored per second)
+template<class V, typename V::vec (*Func)(typename V::vec)>
+double measure_parallel(ThreadPool &pool) {
+  typedef typename V::elem elem;
+  size_t n = memory_working_set() / (2 * sizeof(elem));
+  FirstTouchArray<elem> in(n), out(n);
+  const auto &values = get_test_values(elem());
+  first_touch(pool, in.data(), n, [&](size_t i) { return values[i % values.size()]; });
+  first_touch(pool, out.data(), n, [](size_t) { return elem(0); });
+  Measurement m = timer->measure([&]() {
+    parallel_apply_array<V, Func>(pool, out.data(), in.data(), n, recip_rsqrt_streaming_threshold());
+  }, double(n));
+  checksum_sink = double(out[n / 2]);
+  return 2.0 * sizeof(elem) * n / m.seconds * 1e-9;
+}
+
+void print_scaling_header() {
+  printf("%-28s", "GB/s with threads:");
+  for (size_t p = 0; p < scaling_pools.size(); p++)
+    printf(" %7d", scaling_pools[p]->size());
+  printf("\n");
+}
+
+template<class V, typename V::vec (*Func)(typename V::vec)>
+void test_scaling(const char *name) {
+  printf("%-28s", name);
+  for (size_t p = 0; p < scaling_pools.size(); p++)
+    printf(" %7.2f", measure_parallel<V, Func>(*scaling_pools[p]));
+  printf("\n");
+}
+
+#define TEST_SCALING(tested_func, vec) test_scaling<vec, tested_func>(#tested_func)
+
+//================ Main tables ===============
+
+//kernels of recip, rsqrt, div/sqrt and rcbrt/rqrt tables in order of printing
+void register_kernels() {
+  registry_table = "recip";
+  REGISTER_KERNEL(recip_float4_ieee, recip, float4);
+  REGISTER_KERNEL(recip_float4_fast, recip, float4);
+  REGISTER_KERNEL(recip_float4_nr1, recip, float4);
+#ifdef __AVX2__
+  REGISTER_KERNEL(recip_float8_ieee, recip, float8);
+  REGISTER_KERNEL(recip_float8_fast, recip, float8);
+  REGISTER_KERNEL(recip_float8_nr1, recip, float8);
+#endif
+
+  REGISTER_KERNEL(recip_double2_ieee, recip, double2);
+  REGISTER_KERNEL(recip_double2_fast, recip, double2);
+  REGISTER_KERNEL(recip_double2_nr1, recip, double2);
+  REGISTER_KERNEL(recip_double2_nr2, recip, double2);
+
+  REGISTER_KERNEL(recip_double2_r3, recip, double2);
+  REGISTER_KERNEL(recip_double2_r4, recip, double2);
+  REGISTER_KERNEL(recip_double2_r5, recip, double2);
+  REGISTER_KERNEL(recip_double2_magic, recip, double2);
+  REGISTER_KERNEL(recip_double2_magic_r5, recip, double2);
+#ifdef __FMA__
+  REGISTER_KERNEL(recip_double2_fma, recip, double2);
+  REGISTER_KERNEL(recip_double2_cr, recip, double2);
+#endif
+  REGISTER_KERNEL(recip_double2x2_fast, recip, double2x2);
+  REGISTER_KERNEL(recip_double2x2_r5, recip, double2x2);
+#ifdef __AVX2__
+  REGISTER_KERNEL(recip_double4_ieee, recip, double4);
+  REGISTER_KERNEL(recip_double4_fast, recip, double4);
+  REGISTER_KERNEL(recip_double4_nr1, recip, double4);
+  REGISTER_KERNEL(recip_double4_nr2, recip, double4);
+  REGISTER_KERNEL(recip_double4_r3, recip, double4);
+  REGISTER_KERNEL(recip_double4_r4, recip, double4);
+  REGISTER_KERNEL(recip_double4_r5, recip, double4);
+  REGISTER_KERNEL(recip_double4_magic, recip, double4);
+  REGISTER_KERNEL(recip_double4_magic_r5, recip, double4);
+#ifdef __FMA__
+  REGISTER_KERNEL(recip_double4_fma, recip, double4);
+  REGISTER_KERNEL(recip_double4_cr, recip, double4);
+#endif
+  REGISTER_KERNEL(recip_double4_table_seed<6>, recip, double4);
+  REGISTER_KERNEL(recip_double4_table_seed<8>, recip, double4);
+  REGISTER_KERNEL(recip_double4_table_seed<10>, recip, double4);
+  REGISTER_KERNEL(recip_double4_table_seed<12>, recip, double4);
+  REGISTER_KERNEL(recip_double4_table_r3<6>, recip, double4);
+  REGISTER_KERNEL(recip_double4_table_r3<8>, recip, double4);
+  REGISTER_KERNEL(recip_double4_table_r3<10>, recip, double4);
+  REGISTER_KERNEL(recip_double4_table_r3<12>, recip, double4);
+#endif
+
+  REGISTER_CORRECTORS(recip, Recip, float4, 3);
+  REGISTER_CORRECTORS(recip, Recip, double2, 6);
+  REGISTER_CORRECTORS(recip, Recip, double2x2, 6);
+#ifdef __AVX2__
+  REGISTER_CORRECTORS(recip, Recip, float8, 3);
+  REGISTER_CORRECTORS(recip, Recip, double4, 6);
+#endif
+
+  registry_table = "rsqrt";
+  REGISTER_KERNEL(rsqrt_float4_ieee, rsqrt, float4);
+  REGISTER_KERNEL(rsqrt_float4_fast, rsqrt, float4);
+  REGISTER_KERNEL(rsqrt_float4_nr1, rsqrt, float4);
+#ifdef __AVX2__
+  REGISTER_KERNEL(rsqrt_float8_ieee, rsqrt, float8);
+  REGISTER_KERNEL(rsqrt_float8_fast, rsqrt, float8);
+  REGISTER_KERNEL(rsqrt_float8_nr1, rsqrt, float8);
+#endif
   
-  TEST_PRECISION   (rsqrt_double2_ieee, rsqrt_double2_ieee, double2);
-  TEST_PERFORMANCE (rsqrt_double2_ieee, double2);
-  TEST_PRECISION   (rsqrt_double2_fast, rsqrt_double2_ieee, double2);
-  TEST_PERFORMANCE (rsqrt_double2_fast, double2);
-  TEST_PRECISION   (rsqrt_double2_nr1, rsqrt_double2_ieee, double2);
-  TEST_PERFORMANCE (rsqrt_double2_nr1, double2);
-  TEST_PRECISION   (rsqrt_double2_nr2, rsqrt_double2_ieee, double2);
-  TEST_PERFORMANCE (rsqrt_double2_nr2, double2);
-
-  TEST_PRECISION   (rsqrt_double2_r2, rsqrt_double2_ieee, double2);
-  TEST_PERFORMANCE (rsqrt_double2_r2, double2);
-  TEST_PRECISION   (rsqrt_double2_r3, rsqrt_double2_ieee, double2);
-  TEST_PERFORMANCE (rsqrt_double2_r3, double2);
-  TEST_PRECISION   (rsqrt_double2_r4, rsqrt_double2_ieee, double2);
-  TEST_PERFORMANCE (rsqrt_double2_r4, double2);
-  TEST_PRECISION   (rsqrt_double2_r5, rsqrt_double2_ieee, double2);
-  TEST_PERFORMANCE (rsqrt_double2_r5, double2);
-
-
-  return 0;
+  REGISTER_KERNEL(rsqrt_double2_ieee, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_fast, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_nr1, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_nr2, rsqrt, double2);
+
+  REGISTER_KERNEL(rsqrt_double2_r2, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_r3, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_r4, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_r5, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_magic, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_magic_r5, rsqrt, double2);
+#ifdef __FMA__
+  REGISTER_KERNEL(rsqrt_double2_fma, rsqrt, double2);
+  REGISTER_KERNEL(rsqrt_double2_cr, rsqrt, double2);
+#endif
+  REGISTER_KERNEL(rsqrt_double2x2_fast, rsqrt, double2x2);
+  REGISTER_KERNEL(rsqrt_double2x2_r5, rsqrt, double2x2);
+#ifdef __AVX2__
+  REGISTER_KERNEL(rsqrt_double4_ieee, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_fast, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_nr1, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_nr2, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_r2, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_r3, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_r4, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_r5, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_magic, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_magic_r5, rsqrt, double4);
+#ifdef __FMA__
+  REGISTER_KERNEL(rsqrt_double4_fma, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_cr, rsqrt, double4);
+#endif
+  REGISTER_KERNEL(rsqrt_double4_table_seed<6>, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_table_seed<8>, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_table_seed<10>, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_table_seed<12>, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_table_r3<6>, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_table_r3<8>, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_table_r3<10>, rsqrt, double4);
+  REGISTER_KERNEL(rsqrt_double4_table_r3<12>, rsqrt, double4);
+#endif
+
+  REGISTER_CORRECTORS(rsqrt, Rsqrt, float4, 3);
+  REGISTER_CORRECTORS(rsqrt, Rsqrt, double2, 6);
+  REGISTER_CORRECTORS(rsqrt, Rsqrt, double2x2, 6);
+#ifdef __AVX2__
+  REGISTER_CORRECTORS(rsqrt, Rsqrt, float8, 3);
+  REGISTER_CORRECTORS(rsqrt, Rsqrt, double4, 6);
+#endif
+
+  registry_table = "div/sqrt";
+  REGISTER_DIV(div_float4_ieee, float4);
+  REGISTER_DIV(div_float4_fast, float4);
+  REGISTER_DIV(div_float4_nr1, float4);
+#ifdef __AVX2__
+  REGISTER_DIV(div_float8_ieee, float8);
+  REGISTER_DIV(div_float8_fast, float8);
+  REGISTER_DIV(div_float8_nr1, float8);
+#endif
+  REGISTER_DIV(div_double2_ieee, double2);
+  REGISTER_DIV(div_double2_fast, double2);
+  REGISTER_DIV(div_double2_nr1, double2);
+  REGISTER_DIV(div_double2_r3, double2);
+#ifdef __AVX2__
+  REGISTER_DIV(div_double4_ieee, double4);
+  REGISTER_DIV(div_double4_fast, double4);
+  REGISTER_DIV(div_double4_nr1, double4);
+  REGISTER_DIV(div_double4_r3, double4);
+#endif
+  REGISTER_SQRT(sqrt_float4_ieee, float4);
+  REGISTER_SQRT(sqrt_float4_fast, float4);
+  REGISTER_SQRT(sqrt_float4_nr1, float4);
+#ifdef __AVX2__
+  REGISTER_SQRT(sqrt_float8_ieee, float8);
+  REGISTER_SQRT(sqrt_float8_fast, float8);
+  REGISTER_SQRT(sqrt_float8_nr1, float8);
+#endif
+  REGISTER_SQRT(sqrt_double2_ieee, double2);
+  REGISTER_SQRT(sqrt_double2_fast, double2);
+  REGISTER_SQRT(sqrt_double2_nr1, double2);
+  REGISTER_SQRT(sqrt_double2_r3, double2);
+#ifdef __AVX2__
+  REGISTER_SQRT(sqrt_double4_ieee, double4);
+  REGISTER_SQRT(sqrt_double4_fast, double4);
+  REGISTER_SQRT(sqrt_double4_nr1, double4);
+  REGISTER_SQRT(sqrt_double4_r3, double4);
+#endif
+
+  registry_table = "rcbrt/rqrt";
+  REGISTER_KERNEL(rcbrt_float4_cbrt, rcbrt, float4);
+  REGISTER_KERNEL(rcbrt_float4_fast, rcbrt, float4);
+  REGISTER_KERNEL(rcbrt_float4_r<4>, rcbrt, float4);
+  REGISTER_KERNEL(rcbrt_float4_r<6>, rcbrt, float4);
+  REGISTER_KERNEL(rcbrt_float4_r3r<2>, rcbrt, float4);
+  REGISTER_KERNEL(rcbrt_float4_r3r<3>, rcbrt, float4);
+  REGISTER_KERNEL(rqrt_float4_ieee, rqrt, float4);
+  REGISTER_KERNEL(rqrt_float4_pow, rqrt, float4);
+  REGISTER_KERNEL(rqrt_float4_fast, rqrt, float4);
+  REGISTER_KERNEL(rqrt_float4_r<2>, rqrt, float4);
+  REGISTER_KERNEL(rqrt_float4_r<3>, rqrt, float4);
+  REGISTER_KERNEL(rcbrt2_float4_pow, rcbrt2, float4);
+  REGISTER_KERNEL(rcbrt2_float4_r3r<3>, rcbrt2, float4);
+#ifdef __AVX2__
+  REGISTER_KERNEL(rcbrt_float8_cbrt, rcbrt, float8);
+  REGISTER_KERNEL(rcbrt_float8_fast, rcbrt, float8);
+  REGISTER_KERNEL(rcbrt_float8_r<6>, rcbrt, float8);
+  REGISTER_KERNEL(rcbrt_float8_r3r<2>, rcbrt, float8);
+  REGISTER_KERNEL(rcbrt_float8_r3r<3>, rcbrt, float8);
+  REGISTER_KERNEL(rqrt_float8_ieee, rqrt, float8);
+  REGISTER_KERNEL(rqrt_float8_pow, rqrt, float8);
+  REGISTER_KERNEL(rqrt_float8_fast, rqrt, float8);
+  REGISTER_KERNEL(rqrt_float8_r<2>, rqrt, float8);
+  REGISTER_KERNEL(rqrt_float8_r<3>, rqrt, float8);
+  REGISTER_KERNEL(rcbrt2_float8_pow, rcbrt2, float8);
+  REGISTER_KERNEL(rcbrt2_float8_r3r<3>, rcbrt2, float8);
+#endif
+  REGISTER_KERNEL(rcbrt_double2_cbrt, rcbrt, double2);
+  REGISTER_KERNEL(rcbrt_double2_fast, rcbrt, double2);
+  REGISTER_KERNEL(rcbrt_double2_r3r<4>, rcbrt, double2);
+  REGISTER_KERNEL(rcbrt_double2_r3r<5>, rcbrt, double2);
+  REGISTER_KERNEL(rqrt_double2_ieee, rqrt, double2);
+  REGISTER_KERNEL(rqrt_double2_pow, rqrt, double2);
+  REGISTER_KERNEL(rqrt_double2_fast, rqrt, double2);
+  REGISTER_KERNEL(rqrt_double2_r<5>, rqrt, double2);
+  REGISTER_KERNEL(rqrt_double2_r<6>, rqrt, double2);
+  REGISTER_KERNEL(rcbrt2_double2_pow, rcbrt2, double2);
+  REGISTER_KERNEL(rcbrt2_double2_r3r<5>, rcbrt2, double2);
+#ifdef __AVX2__
+  REGISTER_KERNEL(rcbrt_double4_cbrt, rcbrt, double4);
+  REGISTER_KERNEL(rcbrt_double4_fast, rcbrt, double4);
+  REGISTER_KERNEL(rcbrt_double4_r3r<4>, rcbrt, double4);
+  REGISTER_KERNEL(rcbrt_double4_r3r<5>, rcbrt, double4);
+  REGISTER_KERNEL(rqrt_double4_ieee, rqrt, double4);
+  REGISTER_KERNEL(rqrt_double4_pow, rqrt, double4);
+  REGISTER_KERNEL(rqrt_double4_fast, rqrt, double4);
+  REGISTER_KERNEL(rqrt_double4_r<5>, rqrt, double4);
+  REGISTER_KERNEL(rqrt_double4_r<6>, rqrt, double4);
+  REGISTER_KERNEL(rcbrt2_double4_pow, rcbrt2, double4);
+  REGISTER_KERNEL(rcbrt2_double4_r3r<5>, rcbrt2, double4);
+#endif
+}
+
+//================ Autotuning of library ===============
+
+//instruction sets of library (see recip_rsqrt_select_isa)
+const char *const library_isas[] = {"sse2", "avx2", "avx512"};
+const int library_isas_num = sizeof(library_isas) / sizeof(library_isas[0]);
+
+//accuracy required from each PrecisionTier (see recip_rsqrt.h): both relative error and error in ulps must be within limits
+//Exact tier is not tuned: it promises IEEE operations, and 1/sqrt(x) computed by them is not correctly rounded
+struct ErrorBudget {
+  double maxRel, maxUlp;
+};
+const int tuned_tiers = 3;
+const ErrorBudget tier_budgets[tuned_tiers] = {
+  {1.0 / 2048.0, DBL_MAX},    //Fast
+  {5e-7, DBL_MAX},            //Medium
+  {DBL_MAX, 4.0},             //High
+};
+
+struct TunedKernel {
+  const char *name;
+  PrecisionStats prec;
+  double cycles;    //per element, on arrays in L1 cache
+  bool pareto;      //no other kernel is both faster and more precise
+};
+
+//errors of bulk function on whole input stream, and cycles per element on arrays in L1 cache
+template<class T, class Func>
+void measure_bulk(Func func, dd (*reference)(double), const InputStream<T> &inputs, PrecisionStats &prec, double &cycles) {
+  const size_t block = input_block_size, passes = 16;
+  vector<T, aligned_allocator<T, Alignment::AVX>> out(block);
+  const T *timedInput = get_test_values(T()).data();
+
+  PrecisionAccumulator acc;
+  for_each_input_block(inputs, [&](const T *in, size_t, size_t len) {
+    func(out.data(), in, len);
+    for (size_t j = 0; j < len; j++)
+      acc.add(out[j], reference(double(in[j])));
+  });
+  prec = acc.stats();
+
+  Measurement m = timer->measure([&]() {
+    for (size_t p = 0; p < passes; p++)
+      func(out.data(), timedInput, block);
+  }, double(block * passes));
+  cycles = m.cycles.median;
+}
+
+//measures all candidate kernels of one function and type on current instruction set,
+//prints them with Pareto front of max error vs cycles,
+//then writes the fastest kernel meeting error budget of each tier to tuning file
+template<class T>
+void autotune_family(const char *function, void (*bulk_func)(T*, const T*, size_t, PrecisionTier), dd (*reference)(double),
+  const InputStream<T> &inputs, FILE *file)
+{
+  const char *type = (is_same<T, float>::value ? "float" : "double");
+  const PrecisionTier slot = PrecisionTier::Exact;    //candidate is selected here while being measured
+
+  vector<TunedKernel> tuned;
+  for (int c = 0; c < recip_rsqrt_candidates_num(function, type); c++) {
+    TunedKernel k;
+    k.name = recip_rsqrt_candidate_name(function, type, c);
+    recip_rsqrt_select_kernel(function, type, slot, k.name);
+    measure_bulk<T>([&](T *out, const T *in, size_t n) { bulk_func(out, in, n, slot); }, reference, inputs, k.prec, k.cycles);
+    tuned.push_back(k);
+  }
+
+  sort(tuned.begin(), tuned.end(), [](const TunedKernel &a, const TunedKernel &b) { return a.cycles < b.cycles; });
+  double bestUlp = DBL_MAX;
+  for (size_t i = 0; i < tuned.size(); i++) {
+    tuned[i].pareto = (tuned[i].prec.maxUlp < bestUlp);
+    bestUlp = min(bestUlp, tuned[i].prec.maxUlp);
+  }
+
+  printf("%s %s %s:\n", recip_rsqrt_isa(), function, type);
+  printf("  %-12s %9s %9s %7s %10s\n", "kernel", "max ulp", "max rel", "CR%", "per elem");
+  for (size_t i = 0; i < tuned.size(); i++) {
+    const TunedKernel &k = tuned[i];
+    printf("  %-12s %9.3g %9.3g %7.3f %10.3f%s\n", k.name, k.prec.maxUlp, k.prec.maxRel, k.prec.correctlyRounded * 100.0,
+      k.cycles, k.pareto ? "  pareto" : "");
+  }
+  printf("  chosen:");
+  for (int t = 0; t < tuned_tiers; t++) {
+    const ErrorBudget &budget = tier_budgets[t];
+    const char *tier = recip_rsqrt_tier_name(PrecisionTier(t));
+    size_t i = 0;
+    while (i < tuned.size() && !(tuned[i].prec.maxRel <= budget.maxRel && tuned[i].prec.maxUlp <= budget.maxUlp))
+      i++;
+    if (i == tuned.size()) {
+      printf("  %s = (none, default kept)", tier);
+      continue;
+    }
+    const TunedKernel &k = tuned[i];
+    printf("  %s = %s", tier, k.name);
+    fprintf(file, "%-7s %-6s %-7s %-7s %-10s  # max ulp %.3g, max rel %.3g, %.3f cycles per element\n",
+      recip_rsqrt_isa(), function, type, tier, k.name, k.prec.maxUlp, k.prec.maxRel, k.cycles);
+  }
+  printf("\n\n");
+}
+
+//tunes every supported instruction set, saves choices to tuning file and loads it
+bool autotune(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (!file) {
+    printf("Cannot write tuning file %s\n", path);
+    return false;
+  }
+  fprintf(file, "# recip_rsqrt tuning generated by --autotune: isa function type tier kernel\n");
+  string originalIsa = recip_rsqrt_isa();
+  for (int i = 0; i < library_isas_num; i++) {
+    if (!recip_rsqrt_select_isa(library_isas[i]))
+      continue;
+    autotune_family<float>("recip", recip, reference_recip, test_stream_float, file);
+    autotune_family<double>("recip", recip, reference_recip, test_stream_double, file);
+    autotune_family<float>("rsqrt", rsqrt, reference_rsqrt, test_stream_float, file);
+    autotune_family<double>("rsqrt", rsqrt, reference_rsqrt, test_stream_double, file);
+  }
+  fclose(file);
+
+  recip_rsqrt_select_isa(originalIsa.c_str());
+  if (!recip_rsqrt_load_tuning(path)) {
+    printf("Failed to load tuning file %s\n", path);
+    return false;
+  }
+  printf("Tuning saved to %s, library on %s uses:\n", path, recip_rsqrt_isa());
+  const char *families[4][2] = {{"recip", "float"}, {"recip", "double"}, {"rsqrt", "float"}, {"rsqrt", "double"}};
+  for (int f = 0; f < 4; f++) {
+    printf("  %s %-7s", families[f][0], families[f][1]);
+    for (int t = 0; t < 4; t++)
+      printf("  %s = %s", recip_rsqrt_tier_name(PrecisionTier(t)), recip_rsqrt_selected_kernel(families[f][0], families[f][1], PrecisionTier(t)));
+    printf("\n");
+  }
+  return true;
+}
+
+//================ Compiler baselines ===============
+
+//plain loops compiled with different flags (see autovec.h)
+const AutovecBaseline *const autovec_baselines[] = {
+  &autovec_scalar, &autovec_sse2, &autovec_sse2_recip, &autovec_avx2, &autovec_avx2_recip, &autovec_avx512, &autovec_avx512_recip
+};
+const int autovec_baselines_num = sizeof(autovec_baselines) / sizeof(autovec_baselines[0]);
+
+template<class T> using BulkFunc = void (*)(T*, const T*, size_t);
+
+static void print_bulk_row(const char *isa, const char *code, const PrecisionStats &prec, double cycles, const char *note) {
+  printf("  %-7s %-22s %9.3g %9.3g %7.3f %10.3f  %s\n", isa, code, prec.maxUlp, prec.maxRel, prec.correctlyRounded * 100.0, cycles, note);
+}
+
+//for each supported instruction set, measures compiler baselines built for it and all tiers of library,
+//with the same passes as autotuning
+template<class T>
+void compare_with_compiler(const char *function, void (*bulk_func)(T*, const T*, size_t, PrecisionTier), BulkFunc<T> AutovecBaseline::*baseline,
+  dd (*reference)(double), const InputStream<T> &inputs)
+{
+  const char *type = (is_same<T, float>::value ? "float" : "double");
+  printf("%s %s:\n", function, type);
+  printf("  %-7s %-22s %9s %9s %7s %10s\n", "isa", "code", "max ulp", "max rel", "CR%", "per elem");
+  for (int i = 0; i < library_isas_num; i++) {
+    const char *isa = library_isas[i];
+    if (!recip_rsqrt_select_isa(isa))
+      continue;
+    PrecisionStats prec;
+    double cycles;
+    for (int b = 0; b < autovec_baselines_num; b++) {
+      const AutovecBaseline &base = *autovec_baselines[b];
+      if (strcmp(base.isa, isa) != 0)
+        continue;
+      measure_bulk<T>(base.*baseline, reference, inputs, prec, cycles);
+      string code = string("compiler ") + base.name;
+      print_bulk_row(isa, code.c_str(), prec, cycles, base.flags);
+    }
+    for (int t = 0; t < 4; t++) {
+      PrecisionTier tier = PrecisionTier(t);
+      measure_bulk<T>([&](T *out, const T *in, size_t n) { bulk_func(out, in, n, tier); }, reference, inputs, prec, cycles);
+      string code = string("library ") + recip_rsqrt_tier_name(tier);
+      print_bulk_row(isa, code.c_str(), prec, cycles, recip_rsqrt_selected_kernel(function, type, tier));
+    }
+  }
+  printf("\n");
+}
+
+void compare_with_compiler_all() {
+  string originalIsa = recip_rsqrt_isa();
+  compare_with_compiler<float>("recip", recip, &AutovecBaseline::recip_float, reference_recip, test_stream_float);
+  compare_with_compiler<double>("recip", recip, &AutovecBaseline::recip_double, reference_recip, test_stream_double);
+  compare_with_compiler<float>("rsqrt", rsqrt, &AutovecBaseline::rsqrt_float, reference_rsqrt, test_stream_float);
+  compare_with_compiler<double>("rsqrt", rsqrt, &AutovecBaseline::rsqrt_double, reference_rsqrt, test_stream_double);
+  recip_rsqrt_select_isa(originalIsa.c_str());
+}
+
+//parses comma-separated list of values (e.g. "1,4,16"), each of them must be in values[0..num)
+bool parse_counts(const char *str, const int *values, int num, bool *enabled) {
+  for (int k = 0; k < num; k++)
+    enabled[k] = false;
+  while (*str) {
+    char *end;
+    long value = strtol(str, &end, 10);
+    int k = int(find(values, values + num, value) - values);
+    if (end == str || k == num)
+      return false;
+    enabled[k] = true;
+    str = (*end == ',' ? end + 1 : end);
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  int pinCpu = -1;
+  bool exhaustive = false, sweep = false, scaling = false, baselines = false;
+  const char *tuningPath = 0, *baselinePath = 0;
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (strcmp(arg, "--autotune") == 0 || strncmp(arg, "--autotune=", 11) == 0) {
+      tuningPath = (arg[10] == '=' ? arg + 11 : "recip_rsqrt.tune");
+      continue;
+    }
+    if (strcmp(arg, "--sweep") == 0) {
+      sweep = true;
+      continue;
+    }
+    if (strncmp(arg, "--depth=", 8) == 0 && parse_counts(arg + 8, sweep_depths, sweep_depths_num, sweep_depths_enabled))
+      continue;
+    if (strcmp(arg, "--baselines") == 0) {
+      baselines = true;
+      continue;
+    }
+    if (strcmp(arg, "--scaling") == 0) {
+      scaling = true;
+      continue;
+    }
+    if (strcmp(arg, "--exhaustive") == 0) {
+      exhaustive = true;
+      continue;
+    }
+    if (sscanf(arg, "--exhaustive=%x-%x", &exhaustive_first, &exhaustive_last) == 2 && exhaustive_first <= exhaustive_last) {
+      exhaustive = true;
+      continue;
+    }
+    if (strncmp(arg, "--threads=", 10) == 0 && (threads_num = atoi(arg + 10)) > 0)
+      continue;
+    if (strncmp(arg, "--chains=", 9) == 0 && parse_counts(arg + 9, chain_counts, chain_counts_num, chain_counts_enabled))
+      continue;
+    if (strncmp(arg, "--reps=", 7) == 0 && (measure_options.repetitions = atoi(arg + 7)) > 0)
+      continue;
+    if (strncmp(arg, "--warmup=", 9) == 0 && (measure_options.warmup = atoi(arg + 9)) >= 0)
+      continue;
+    if (strncmp(arg, "--pin=", 6) == 0 && (pinCpu = atoi(arg + 6)) >= 0)
+      continue;
+    if (strcmp(arg, "--timer=tsc") == 0 || strcmp(arg, "--timer=perf") == 0) {
+      measure_options.use_perf = (strcmp(arg, "--timer=perf") == 0);
+      continue;
+    }
+    if (strcmp(arg, "--verbose") == 0) {
+      verbose = true;
+      continue;
+    }
+    if (strncmp(arg, "--filter=", 9) == 0) {
+      kernel_name_filter = arg + 9;
+      continue;
+    }
+    if (strcmp(arg, "--isa=sse2") == 0 || strcmp(arg, "--isa=avx2") == 0) {
+      kernel_isa_filter = arg + 6;
+      continue;
+    }
+    if (strcmp(arg, "--format=json") == 0 || strcmp(arg, "--format=csv") == 0 || strcmp(arg, "--format=text") == 0) {
+      output_format = (arg[9] == 'j' ? OutputFormat::Json : arg[9] == 'c' ? OutputFormat::Csv : OutputFormat::Text);
+      continue;
+    }
+    if (strncmp(arg, "--compare=", 10) == 0) {
+      baselinePath = arg + 10;
+      continue;
+    }
+    if (strncmp(arg, "--tolerance=", 12) == 0 && (regression_tolerance = atof(arg + 12)) >= 0.0)
+      continue;
+    printf("Usage: %s [--chains=1,2,4,8,16] [--reps=5] [--warmup=1] [--pin=CPU] [--timer=perf|tsc] [--verbose]\n", argv[0]);
+    printf("       %s [--filter=NAME,...] [--isa=sse2|avx2] [--format=text|json|csv] [--compare=BASELINE.csv] [--tolerance=10] [...]\n", argv[0]);
+    printf("       %s --exhaustive[=FIRST-LAST] [--threads=N]\n", argv[0]);
+    printf("       %s --autotune[=FILE] [--reps=5] [--warmup=1] [--pin=CPU] [--timer=perf|tsc]\n", argv[0]);
+    printf("       %s --sweep [--depth=1,2,4,8] [--reps=5] [--warmup=1] [--pin=CPU] [--timer=perf|tsc]\n", argv[0]);
+    printf("       %s --baselines [--reps=5] [--warmup=1] [--pin=CPU] [--timer=perf|tsc]\n", argv[0]);
+    printf("       %s --scaling [--threads=N] [--reps=5] [--warmup=1] [--pin=CPU]\n", argv[0]);
+    return 1;
+  }
+
+  if (exhaustive) {
+    //check float kernels on all inputs (bit patterns in hex)
+    printf("Exhaustive test of inputs 0x%08X-0x%08X on %d threads\n", exhaustive_first, exhaustive_last, threads_num);
+    TEST_EXHAUSTIVE(recip_float4_fast, recip_float4_ieee, float4);
+    TEST_EXHAUSTIVE(recip_float4_nr1, recip_float4_ieee, float4);
+    TEST_EXHAUSTIVE(rsqrt_float4_fast, rsqrt_float4_ieee, float4);
+    TEST_EXHAUSTIVE(rsqrt_float4_nr1, rsqrt_float4_ieee, float4);
+#ifdef __AVX2__
+    TEST_EXHAUSTIVE(recip_float8_fast, recip_float8_ieee, float8);
+    TEST_EXHAUSTIVE(recip_float8_nr1, recip_float8_ieee, float8);
+    TEST_EXHAUSTIVE(rsqrt_float8_fast, rsqrt_float8_ieee, float8);
+    TEST_EXHAUSTIVE(rsqrt_float8_nr1, rsqrt_float8_ieee, float8);
+#endif
+    return 0;
+  }
+
+  if (pinCpu >= 0 && !pin_to_cpu(pinCpu))
+    printf("Warning: failed to pin thread to CPU %d\n", pinCpu);
+  Timer mainTimer(measure_options);
+  timer = &mainTimer;
+  //machine-readable results must be alone on stdout
+  FILE *info = (output_format == OutputFormat::Text ? stdout : stderr);
+  if (measure_options.use_perf && !timer->core_cycles())
+    fprintf(info, "Warning: perf counters are not available, falling back to TSC\n");
+  fprintf(info, "Timing: %s, %d warm-up runs, median of %d runs\n\n", timer->description(), measure_options.warmup, measure_options.repetitions);
+
+  if (tuningPath)
+    return autotune(tuningPath) ? 0 : 1;
+
+  if (baselines) {
+    //hand-written kernels of library vs compiler output for each instruction set
+    compare_with_compiler_all();
+    return 0;
+  }
+
+  if (scaling) {
+    //memory bandwidth of kernels with growing number of threads
+    init_scaling_pools();
+    print_scaling_header();
+#ifdef __AVX2__
+    TEST_SCALING(recip_float8_fast, float8);
+    TEST_SCALING(recip_float8_nr1, float8);
+    TEST_SCALING(recip_float8_ieee, float8);
+    TEST_SCALING(recip_double4_fast, double4);
+    TEST_SCALING(recip_double4_r5, double4);
+    TEST_SCALING(recip_double4_ieee, double4);
+    TEST_SCALING(rsqrt_float8_fast, float8);
+    TEST_SCALING(rsqrt_float8_nr1, float8);
+    TEST_SCALING(rsqrt_float8_ieee, float8);
+    TEST_SCALING(rsqrt_double4_fast, double4);
+    TEST_SCALING(rsqrt_double4_r5, double4);
+    TEST_SCALING(rsqrt_double4_ieee, double4);
+#else
+    TEST_SCALING(recip_float4_fast, float4);
+    TEST_SCALING(recip_float4_nr1, float4);
+    TEST_SCALING(recip_float4_ieee, float4);
+    TEST_SCALING(recip_double2_fast, double2);
+    TEST_SCALING(recip_double2_r5, double2);
+    TEST_SCALING(recip_double2_ieee, double2);
+    TEST_SCALING(rsqrt_float4_fast, float4);
+    TEST_SCALING(rsqrt_float4_nr1, float4);
+    TEST_SCALING(rsqrt_float4_ieee, float4);
+    TEST_SCALING(rsqrt_double2_fast, double2);
+    TEST_SCALING(rsqrt_double2_r5, double2);
+    TEST_SCALING(rsqrt_double2_ieee, double2);
+#endif
+    for (size_t p = 0; p < scaling_pools.size(); p++)
+      delete scaling_pools[p];
+    return 0;
+  }
+
+  if (sweep) {
+    //throughput of kernels on working sets of different size
+    init_sweep_sizes();
+    print_sweep_header();
+#ifdef __AVX2__
+    TEST_SWEEP(recip_float8_fast, float8);
+    TEST_SWEEP(recip_float8_nr1, float8);
+    TEST_SWEEP(recip_float8_ieee, float8);
+    TEST_SWEEP(recip_double4_fast, double4);
+    TEST_SWEEP(recip_double4_r5, double4);
+    TEST_SWEEP(recip_double4_ieee, double4);
+    TEST_SWEEP(rsqrt_float8_fast, float8);
+    TEST_SWEEP(rsqrt_float8_nr1, float8);
+    TEST_SWEEP(rsqrt_float8_ieee, float8);
+    TEST_SWEEP(rsqrt_double4_fast, double4);
+    TEST_SWEEP(rsqrt_double4_r5, double4);
+    TEST_SWEEP(rsqrt_double4_ieee, double4);
+#else
+    TEST_SWEEP(recip_float4_fast, float4);
+    TEST_SWEEP(recip_float4_nr1, float4);
+    TEST_SWEEP(recip_float4_ieee, float4);
+    TEST_SWEEP(recip_double2_fast, double2);
+    TEST_SWEEP(recip_double2_r5, double2);
+    TEST_SWEEP(recip_double2_ieee, double2);
+    TEST_SWEEP(rsqrt_float4_fast, float4);
+    TEST_SWEEP(rsqrt_float4_nr1, float4);
+    TEST_SWEEP(rsqrt_float4_ieee, float4);
+    TEST_SWEEP(rsqrt_double2_fast, double2);
+    TEST_SWEEP(rsqrt_double2_r5, double2);
+    TEST_SWEEP(rsqrt_double2_ieee, double2);
+#endif
+    return 0;
+  }
+
+  //main tables: recip, rsqrt, div/sqrt, rcbrt/rqrt
+
+  vector<BaselineRow> baseline;
+  if (baselinePath && !load_baseline(baselinePath, baseline)) {
+    fprintf(stderr, "Cannot read baseline %s (csv written by --format=csv)\n", baselinePath);
+    return 1;
+  }
+  register_kernels();
+  int regressions = run_registered_kernels(baselinePath ? &baseline : 0);
+  //other sections are not in registry, they are run only without filters in text format
+  if (output_format != OutputFormat::Text || !kernel_name_filter.empty() || !kernel_isa_filter.empty())
+    return regressions > 0 ? 1 : 0;
+
+  //test special values: IEEE semantics of safe variants and their cost
+
+  printf("\n%-28s %9s  %14s  %22s  %17s  %17s\n", "special values", "fails/safe", "latency/safe", "per elem/safe/fix-ups", "subnormal/FTZ+DAZ", "safe: sub/FTZ+DAZ");
+  TEST_SPECIAL(recip_float4_fast, recip, float4, 1.0 / 2048);
+  TEST_SPECIAL(recip_float4_nr1, recip, float4, 5e-7);
+  TEST_SPECIAL(rsqrt_float4_fast, rsqrt, float4, 1.0 / 2048);
+  TEST_SPECIAL(rsqrt_float4_nr1, rsqrt, float4, 5e-7);
+  TEST_SPECIAL(recip_double2_fast, recip, double2, 1.0 / 2048);
+  TEST_SPECIAL(recip_double2_r5, recip, double2, 4 * DBL_EPSILON);
+  TEST_SPECIAL(rsqrt_double2_fast, rsqrt, double2, 1.0 / 2048);
+  TEST_SPECIAL(rsqrt_double2_r5, rsqrt, double2, 4 * DBL_EPSILON);
+#ifdef __AVX2__
+  TEST_SPECIAL(recip_float8_fast, recip, float8, 1.0 / 2048);
+  TEST_SPECIAL(recip_float8_nr1, recip, float8, 5e-7);
+  TEST_SPECIAL(rsqrt_float8_fast, rsqrt, float8, 1.0 / 2048);
+  TEST_SPECIAL(rsqrt_float8_nr1, rsqrt, float8, 5e-7);
+  TEST_SPECIAL(recip_double4_fast, recip, double4, 1.0 / 2048);
+  TEST_SPECIAL(recip_double4_r5, recip, double4, 4 * DBL_EPSILON);
+  TEST_SPECIAL(rsqrt_double4_fast, rsqrt, double4, 1.0 / 2048);
+  TEST_SPECIAL(rsqrt_double4_r5, rsqrt, double4, 4 * DBL_EPSILON);
+#endif
+
+  //test kernels on fp16 / bf16 arrays against the same kernels on float arrays
+
+  printf("\n%-28s %8s %8s %6s %9s %9s\n", "narrow floats", "max ulp", "CR%", "edge", "L1/elem", "mem/elem");
+  TEST_NARROW(recip_float4_fast, recip, float4, BFloat16);
+  TEST_NARROW(recip_float4_nr1, recip, float4, BFloat16);
+  TEST_NARROW(rsqrt_float4_fast, rsqrt, float4, BFloat16);
+  TEST_NARROW(rsqrt_float4_nr1, rsqrt, float4, BFloat16);
+#ifdef NARROW_F16C
+  TEST_NARROW(recip_float4_fast, recip, float4, Half);
+  TEST_NARROW(recip_float4_nr1, recip, float4, Half);
+  TEST_NARROW(rsqrt_float4_fast, rsqrt, float4, Half);
+  TEST_NARROW(rsqrt_float4_nr1, rsqrt, float4, Half);
+#endif
+  TEST_NARROW_FLOAT(recip_float4_fast, float4);
+  TEST_NARROW_FLOAT(recip_float4_nr1, float4);
+  TEST_NARROW_FLOAT(rsqrt_float4_fast, float4);
+  TEST_NARROW_FLOAT(rsqrt_float4_nr1, float4);
+#ifdef __AVX2__
+  TEST_NARROW(recip_float8_fast, recip, float8, BFloat16);
+  TEST_NARROW(recip_float8_nr1, recip, float8, BFloat16);
+  TEST_NARROW(rsqrt_float8_fast, rsqrt, float8, BFloat16);
+  TEST_NARROW(rsqrt_float8_nr1, rsqrt, float8, BFloat16);
+#ifdef NARROW_F16C
+  TEST_NARROW(recip_float8_fast, recip, float8, Half);
+  TEST_NARROW(recip_float8_nr1, recip, float8, Half);
+  TEST_NARROW(rsqrt_float8_fast, rsqrt, float8, Half);
+  TEST_NARROW(rsqrt_float8_nr1, rsqrt, float8, Half);
+#endif
+  TEST_NARROW_FLOAT(recip_float8_fast, float8);
+  TEST_NARROW_FLOAT(recip_float8_nr1, float8);
+  TEST_NARROW_FLOAT(rsqrt_float8_fast, float8);
+  TEST_NARROW_FLOAT(rsqrt_float8_nr1, float8);
+#endif
+
+#ifdef __FMA__
+  //test correct rounding of double kernels on hard cases, compared with IEEE division and r5
+
+  printf("\n%-28s %18s %18s %8s\n", "correct rounding", "hard misrounded", "random misrounded", "max ulp");
+  TEST_CORRECT_ROUNDING(recip_double2_ieee, recip, double2);
+  TEST_CORRECT_ROUNDING(recip_double2_r5, recip, double2);
+  TEST_CORRECT_ROUNDING(recip_double2_fma, recip, double2);
+  TEST_CORRECT_ROUNDING(recip_double2_cr, recip, double2);
+  TEST_CORRECT_ROUNDING(rsqrt_double2_ieee, rsqrt, double2);
+  TEST_CORRECT_ROUNDING(rsqrt_double2_r5, rsqrt, double2);
+  TEST_CORRECT_ROUNDING(rsqrt_double2_fma, rsqrt, double2);
+  TEST_CORRECT_ROUNDING(rsqrt_double2_cr, rsqrt, double2);
+#ifdef __AVX2__
+  TEST_CORRECT_ROUNDING(recip_double4_fma, recip, double4);
+  TEST_CORRECT_ROUNDING(recip_double4_cr, recip, double4);
+  TEST_CORRECT_ROUNDING(rsqrt_double4_fma, rsqrt, double4);
+  TEST_CORRECT_ROUNDING(rsqrt_double4_cr, rsqrt, double4);
+#endif
+#endif
+
+  //test division of integer arrays via float / double reciprocal against scalar div
+
+  printf("\n%-52s %-6s %10s %10s %9s\n", "integer division", "type", "checked", "mismatch", "per elem");
+  TEST_INT_DIV_SCALAR(uint32_t);
+  TEST_INT_DIV(udiv_u32x4_ieee, int32x4, uint32_t);
+  TEST_INT_DIV(udiv_u32x4_float<recip_float4_ieee>, int32x4, uint32_t);
+  TEST_INT_DIV(udiv_u32x4_float<recip_float4_nr1>, int32x4, uint32_t);
+  TEST_INT_DIV(udiv_u32x4_double<recip_double2_nr2>, int32x4, uint32_t);
+  TEST_INT_DIV(udiv_u32x4_double<recip_double2_r3>, int32x4, uint32_t);
+#ifdef __AVX2__
+  TEST_INT_DIV(udiv_u32x8_ieee, int32x8, uint32_t);
+  TEST_INT_DIV(udiv_u32x8_float<recip_float8_nr1>, int32x8, uint32_t);
+  TEST_INT_DIV(udiv_u32x8_double<recip_double4_nr2>, int32x8, uint32_t);
+  TEST_INT_DIV(udiv_u32x8_double<recip_double4_r3>, int32x8, uint32_t);
+#endif
+  TEST_INT_DIV_SCALAR(int32_t);
+  TEST_INT_DIV(sdiv_i32x4<udiv_u32x4_ieee>, int32x4, int32_t);
+  TEST_INT_DIV(sdiv_i32x4<udiv_u32x4_float<recip_float4_nr1>>, int32x4, int32_t);
+  TEST_INT_DIV(sdiv_i32x4<udiv_u32x4_double<recip_double2_nr2>>, int32x4, int32_t);
+#ifdef __AVX2__
+  TEST_INT_DIV(sdiv_i32x8<udiv_u32x8_ieee>, int32x8, int32_t);
+  TEST_INT_DIV(sdiv_i32x8<udiv_u32x8_float<recip_float8_nr1>>, int32x8, int32_t);
+  TEST_INT_DIV(sdiv_i32x8<udiv_u32x8_double<recip_double4_nr2>>, int32x8, int32_t);
+#endif
+
+  //test double kernels on full exponent range (seeds with conversion to float fail here)
+
+  printf("\n%-28s %9s %8s %8s %7s   (full exponent range)\n", "kernel", "max ulp", "mean ulp", "rms ulp", "CR%");
+  TEST_FULL_RANGE(recip_double2_r5, recip, double2);
+  TEST_FULL_RANGE(recip_double2_magic, recip, double2);
+  TEST_FULL_RANGE(recip_double2_magic_r5, recip, double2);
+  TEST_FULL_RANGE(rsqrt_double2_r5, rsqrt, double2);
+  TEST_FULL_RANGE(rsqrt_double2_magic, rsqrt, double2);
+  TEST_FULL_RANGE(rsqrt_double2_magic_r5, rsqrt, double2);
+#ifdef __AVX2__
+  TEST_FULL_RANGE(recip_double4_r5, recip, double4);
+  TEST_FULL_RANGE(recip_double4_magic, recip, double4);
+  TEST_FULL_RANGE(recip_double4_magic_r5, recip, double4);
+  TEST_FULL_RANGE(rsqrt_double4_r5, rsqrt, double4);
+  TEST_FULL_RANGE(rsqrt_double4_magic, rsqrt, double4);
+  TEST_FULL_RANGE(rsqrt_double4_magic_r5, rsqrt, double4);
+  TEST_FULL_RANGE(recip_double4_table_r3<8>, recip, double4);
+  TEST_FULL_RANGE(rsqrt_double4_table_r3<8>, rsqrt, double4);
+#endif
+
+  //test normalization of 3D / 4D vectors
+
+  printf("\n%-36s %10s %6s %10s\n", "normalization", "max error", "zeros", "per vector");
+  TEST_NORMALIZE_SCALAR(soa, 3);
+  TEST_NORMALIZE(soa, 3, float4, rsqrt_float4_fast);
+  TEST_NORMALIZE(soa, 3, float4, rsqrt_float4_nr1);
+  TEST_NORMALIZE(soa, 3, float4, rsqrt_float4_ieee);
+#ifdef __AVX2__
+  TEST_NORMALIZE(soa, 3, float8, rsqrt_float8_fast);
+  TEST_NORMALIZE(soa, 3, float8, rsqrt_float8_nr1);
+  TEST_NORMALIZE(soa, 3, float8, rsqrt_float8_ieee);
+#endif
+  TEST_NORMALIZE_SCALAR(aos, 3);
+  TEST_NORMALIZE(aos, 3, float4, rsqrt_float4_fast);
+  TEST_NORMALIZE(aos, 3, float4, rsqrt_float4_nr1);
+  TEST_NORMALIZE(aos, 3, float4, rsqrt_float4_ieee);
+#ifdef __AVX2__
+  TEST_NORMALIZE(aos, 3, float8, rsqrt_float8_fast);
+  TEST_NORMALIZE(aos, 3, float8, rsqrt_float8_nr1);
+  TEST_NORMALIZE(aos, 3, float8, rsqrt_float8_ieee);
+#endif
+  TEST_NORMALIZE_SCALAR(soa, 4);
+  TEST_NORMALIZE(soa, 4, float4, rsqrt_float4_fast);
+  TEST_NORMALIZE(soa, 4, float4, rsqrt_float4_nr1);
+  TEST_NORMALIZE(soa, 4, float4, rsqrt_float4_ieee);
+#ifdef __AVX2__
+  TEST_NORMALIZE(soa, 4, float8, rsqrt_float8_fast);
+  TEST_NORMALIZE(soa, 4, float8, rsqrt_float8_nr1);
+  TEST_NORMALIZE(soa, 4, float8, rsqrt_float8_ieee);
+#endif
+  TEST_NORMALIZE_SCALAR(aos, 4);
+  TEST_NORMALIZE(aos, 4, float4, rsqrt_float4_fast);
+  TEST_NORMALIZE(aos, 4, float4, rsqrt_float4_nr1);
+  TEST_NORMALIZE(aos, 4, float4, rsqrt_float4_ieee);
+#ifdef __AVX2__
+  TEST_NORMALIZE(aos, 4, float8, rsqrt_float8_fast);
+  TEST_NORMALIZE(aos, 4, float8, rsqrt_float8_nr1);
+  TEST_NORMALIZE(aos, 4, float8, rsqrt_float8_ieee);
+#endif
+  printf("\n");
+
+  //test array drivers
+
+  TEST_ARRAY(recip_float4_fast, float4);
+  TEST_ARRAY(recip_float4_nr1, float4);
+  TEST_ARRAY(recip_double2_r5, double2);
+  TEST_ARRAY(rsqrt_float4_fast, float4);
+  TEST_ARRAY(rsqrt_float4_nr1, float4);
+  TEST_ARRAY(rsqrt_double2_r5, double2);
+  TEST_ARRAY(recip_double2x2_r5, double2x2);
+  TEST_ARRAY(rsqrt_double2x2_r5, double2x2);
+#ifdef __AVX2__
+  TEST_ARRAY(recip_float8_fast, float8);
+  TEST_ARRAY(recip_float8_nr1, float8);
+  TEST_ARRAY(recip_double4_r5, double4);
+  TEST_ARRAY(rsqrt_float8_fast, float8);
+  TEST_ARRAY(rsqrt_float8_nr1, float8);
+  TEST_ARRAY(rsqrt_double4_r5, double4);
+#endif
+
+  //test dispatched calls
+
+  for (int i = 0; i < library_isas_num; i++) {
+    if (!recip_rsqrt_select_isa(library_isas[i]))
+      continue;
+#ifdef __AVX2__
+    TEST_DISPATCH(recip_float8_fast, recip, Fast, float8);
+    TEST_DISPATCH(recip_float8_nr1, recip, High, float8);
+    TEST_DISPATCH(recip_double4_fast, recip, Fast, double4);
+    TEST_DISPATCH(recip_double4_r5, recip, High, double4);
+    TEST_DISPATCH(rsqrt_float8_fast, rsqrt, Fast, float8);
+    TEST_DISPATCH(rsqrt_float8_nr1, rsqrt, High, float8);
+    TEST_DISPATCH(rsqrt_double4_fast, rsqrt, Fast, double4);
+    TEST_DISPATCH(rsqrt_double4_r5, rsqrt, High, double4);
+    TEST_DISPATCH(sqrt_float8_nr1, recip_rsqrt_sqrt, High, float8);
+    TEST_DISPATCH(sqrt_double4_r3, recip_rsqrt_sqrt, High, double4);
+#else
+    TEST_DISPATCH(recip_float4_fast, recip, Fast, float4);
+    TEST_DISPATCH(recip_float4_nr1, recip, High, float4);
+    TEST_DISPATCH(recip_double2_fast, recip, Fast, double2);
+    TEST_DISPATCH(recip_double2_r5, recip, High, double2);
+    TEST_DISPATCH(rsqrt_float4_fast, rsqrt, Fast, float4);
+    TEST_DISPATCH(rsqrt_float4_nr1, rsqrt, High, float4);
+    TEST_DISPATCH(rsqrt_double2_fast, rsqrt, Fast, double2);
+    TEST_DISPATCH(rsqrt_double2_r5, rsqrt, High, double2);
+    TEST_DISPATCH(sqrt_float4_nr1, recip_rsqrt_sqrt, High, float4);
+    TEST_DISPATCH(sqrt_double2_r3, recip_rsqrt_sqrt, High, double2);
+#endif
+  }
+
+  return regressions > 0 ? 1 : 0;
 }
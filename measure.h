@@ -0,0 +1,118 @@
+#pragma once
+
+//Measurement layer for benchmarks:
+//  * every run is timed with serialized TSC reads (or with perf counters when available),
+//  * code is warmed up first, then measured several times,
+//  * min / median / mean / stddev over repetitions are reported.
+//Core cycles from perf counters do not depend on turbo frequency, unlike TSC ticks.
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include "rdtsc.h"
+#include "perf_counters.h"
+#include "affinity.h"
+
+struct Stats {
+  double min, median, mean, stddev;
+};
+
+static inline Stats compute_stats(std::vector<double> values) {
+  Stats res = {0.0, 0.0, 0.0, 0.0};
+  size_t n = values.size();
+  if (n == 0)
+    return res;
+  std::sort(values.begin(), values.end());
+  res.min = values[0];
+  res.median = (n % 2 ? values[n/2] : (values[n/2 - 1] + values[n/2]) * 0.5);
+  for (size_t i = 0; i < n; i++)
+    res.mean += values[i];
+  res.mean /= n;
+  for (size_t i = 0; i < n; i++)
+    res.stddev += (values[i] - res.mean) * (values[i] - res.mean);
+  res.stddev = std::sqrt(res.stddev / n);
+  return res;
+}
+
+//all values are per unit of work (e.g. per call)
+struct Measurement {
+  Stats cycles;
+  double instructions;    //median, negative if not available
+  double uops;            //median, negative if not available
+  double seconds;         //median wall time of one run (not per unit)
+};
+
+struct MeasureOptions {
+  int warmup;             //number of runs discarded before measurement
+  int repetitions;        //number of measured runs
+  bool use_perf;          //use perf counters if available
+};
+
+class Timer {
+public:
+  Timer(const MeasureOptions &options) : opts(options) {
+    if (opts.use_perf)
+      counters = new PerfCounters();
+    else
+      counters = 0;
+    if (counters && !counters->available()) {
+      delete counters;
+      counters = 0;
+    }
+  }
+  ~Timer() {
+    delete counters;
+  }
+
+  bool core_cycles() const { return counters != 0; }
+  const char *description() const {
+    return core_cycles() ? "core cycles (perf counters)" : "TSC ticks (lfence + rdtsc/rdtscp)";
+  }
+
+  //runs func several times, each run performs given number of work units
+  template<class Func> Measurement measure(Func func, double units) {
+    std::vector<double> cycles, instructions, uops, seconds;
+    for (int r = 0; r < opts.warmup + opts.repetitions; r++) {
+      double c, i = -1.0, u = -1.0;
+      auto wall_start = std::chrono::steady_clock::now();
+      if (counters) {
+        counters->start();
+        func();
+        PerfCounts cnt = counters->stop();
+        c = double(cnt.cycles);
+        if (counters->has_instructions())
+          i = double(cnt.instructions);
+        if (counters->has_uops())
+          u = double(cnt.uops);
+      }
+      else {
+        auto time_start = rdtsc_begin();
+        func();
+        auto time_end = rdtsc_end();
+        c = double(time_end - time_start);
+      }
+      double w = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+      if (r < opts.warmup)
+        continue;
+      cycles.push_back(c / units);
+      instructions.push_back(i / units);
+      uops.push_back(u / units);
+      seconds.push_back(w);
+    }
+
+    Measurement res;
+    res.cycles = compute_stats(cycles);
+    res.instructions = compute_stats(instructions).median;
+    res.uops = compute_stats(uops).median;
+    res.seconds = compute_stats(seconds).median;
+    return res;
+  }
+
+private:
+  Timer(const Timer&);
+  Timer &operator= (const Timer&);
+
+  MeasureOptions opts;
+  PerfCounters *counters;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+//generated by remez.cpp, do not edit
+//minimax_<func>_coefs[N] are coefficients of corrector of order N: x := x + x D(r),
+//where D(r) = P(r) - 1 = d_0 + d_1 r + ... + d_{N-1} r^{N-1} and P minimizes relative error
+//to 1/(1-r) (recip) or 1/sqrt(1-r) (rsqrt) over |r| <= eps; rows for orders below 2 are unused
+
+//recip: eps = 3.662706e-04
+constexpr double minimax_recip_coefs[7][6] = {
+  {0},
+  {0},
+  {6.70770675157535856524e-08, 1.00000006707706751575e+00},    //max relative error 6.708e-08
+  {-1.57772181044202361082e-30, 1.00000010061560464815e+00, 1.00000010061560464815e+00},    //max relative error 1.228e-11
+  {-2.24966649325648751503e-15, 9.99999999999997750335e-01, 1.00000013415414178055e+00, 1.00000013415414178055e+00},    //max relative error 2.250e-15
+  {-6.58276836460481004462e-37, 9.99999999999994375810e-01, 9.99999999999994375810e-01, 1.00000016769268003770e+00, 1.00000016769268003770e+00},    //max relative error 4.120e-19
+  {7.54505156280470958981e-23, 1.00000000000000000000e+00, 9.99999999999989876479e-01, 9.99999999999989876479e-01, 1.00000020123121941972e+00, 1.00000020123121941972e+00},    //max relative error 7.545e-23
+};
+
+//rsqrt: eps = 7.326156e-04
+constexpr double minimax_rsqrt_coefs[7][6] = {
+  {0},
+  {0},
+  {1.00636091787911209180e-07, 5.00000117408779003918e-01},    //max relative error 1.006e-07
+  {-8.43968510083994731720e-15, 5.00000125795122682285e-01, 3.75000141519519742924e-01},    //max relative error 3.072e-11
+  {-9.84629993389872380763e-15, 4.99999999999979322774e-01, 3.75000146760985816620e-01, 3.12500161437092669175e-01},    //max relative error 9.846e-15
+  {9.90893049462514756264e-22, 4.99999999999977845819e-01, 3.74999999999964922563e-01, 3.12500165106119738372e-01, 2.73437678864972665417e-01},    //max relative error 3.246e-18
+  {1.08998243602450582452e-21, 5.00000000000000000000e-01, 3.74999999999963445609e-01, 3.12499999999948649773e-01, 2.73437681616743588766e-01, 2.46093944589378947927e-01},    //max relative error 1.090e-21
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+//Batch kernels on arrays of 16-bit floats: IEEE half precision (fp16) and bfloat16 (bf16).
+//Values are widened to float in registers, float kernel is applied, and results are rounded back
+//to nearest even, so that arrays are never converted to float in memory (half of memory traffic).
+//fp16 is converted with F16C instructions (vcvtph2ps / vcvtps2ph).
+//bf16 is the upper half of float: widening is a shift, narrowing adds rounding bias and truncates.
+//
+//fp16 has 11 bits of mantissa, bf16 has 8 bits (with the implicit one).
+//Raw rcpps / rsqrtps (relative error below 1.5 * 2^-12) is enough for bf16: results are within 0.55 ulp,
+//while fp16 needs one NR step (e.g. recip_float8_nr1) to be rounded correctly, raw seed gives up to 1.1 ulp.
+//Note that recip_float4_nr1 computes square of seed, which underflows for inputs above 2^63, so it does not suit bf16 range.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "vector_traits.h"
+
+//MSVC does not define __F16C__, but /arch:AVX2 enables F16C
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+  #define NARROW_F16C
+#endif
+
+//storage formats: load V::width narrow values widening them to float, store float vector rounding to nearest even;
+//mantissa_bits is the number of stored mantissa bits
+template<class V> struct BFloat16;
+template<class V> struct Half;
+
+//rounds bf16 in the upper halves of 32-bit lanes: NaN is made quiet instead of rounded (bias could turn it into infinity);
+//result is arithmetically shifted down, so that signed saturation of packs_epi32 keeps all 16 bits
+static FORCEINLINE __m128i bf16_round_float4(__m128 x) {
+  __m128i bits = _mm_castps_si128(x);
+  __m128i odd = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+  __m128i rounded = _mm_add_epi32(bits, _mm_add_epi32(odd, _mm_set1_epi32(0x7FFF)));
+  __m128i nan = _mm_castps_si128(_mm_cmpunord_ps(x, x));
+  __m128i quiet = _mm_or_si128(bits, _mm_set1_epi32(0x00400000));
+  return _mm_srai_epi32(_mm_or_si128(_mm_and_si128(nan, quiet), _mm_andnot_si128(nan, rounded)), 16);
+}
+
+template<> struct BFloat16<float4> {
+  typedef __m128 vec;
+  enum { mantissa_bits = 7 };
+  static FORCEINLINE vec load(const uint16_t *p) {
+    return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i*)p)));
+  }
+  static FORCEINLINE void store(uint16_t *p, vec x) {
+    __m128i h = bf16_round_float4(x);
+    _mm_storel_epi64((__m128i*)p, _mm_packs_epi32(h, h));
+  }
+};
+
+#ifdef NARROW_F16C
+template<> struct Half<float4> {
+  typedef __m128 vec;
+  enum { mantissa_bits = 10 };
+  static FORCEINLINE vec load(const uint16_t *p) { return _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)p)); }
+  static FORCEINLINE void store(uint16_t *p, vec x) {
+    _mm_storel_epi64((__m128i*)p, _mm_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT));
+  }
+};
+#endif
+
+#ifdef __AVX2__
+template<> struct BFloat16<float8> {
+  typedef __m256 vec;
+  enum { mantissa_bits = 7 };
+  static FORCEINLINE vec load(const uint16_t *p) {
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)p)), 16));
+  }
+  //the same rounding as bf16_round_float4; packs_epi32 works within 128-bit lanes, so quadwords 0 and 2 are gathered
+  static FORCEINLINE void store(uint16_t *p, vec x) {
+    __m256i bits = _mm256_castps_si256(x);
+    __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(odd, _mm256_set1_epi32(0x7FFF)));
+    __m256i quiet = _mm256_or_si256(bits, _mm256_set1_epi32(0x00400000));
+    __m256 nan = _mm256_cmp_ps(x, x, _CMP_UNORD_Q);
+    __m256i h = _mm256_srai_epi32(_mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(rounded), _mm256_castsi256_ps(quiet), nan)), 16);
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(h, h), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(packed));
+  }
+};
+#endif
+
+#if defined(__AVX2__) && defined(NARROW_F16C)
+template<> struct Half<float8> {
+  typedef __m256 vec;
+  enum { mantissa_bits = 10 };
+  static FORCEINLINE vec load(const uint16_t *p) { return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)p)); }
+  static FORCEINLINE void store(uint16_t *p, vec x) {
+    _mm_storeu_si128((__m128i*)p, _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT));
+  }
+};
+#endif
+
+//out[i] = Func(in[i]) for n values stored in Format (e.g. Half), arrays need not be aligned;
+//output must either coincide with input (in-place) or not overlap it at all.
+//Tail is copied through buffer padded with ones.
+template<template<class> class Format, class V, typename V::vec (*Func)(typename V::vec)>
+static void apply_narrow(uint16_t *out, const uint16_t *in, size_t n) {
+  typedef Format<V> F;
+  const size_t W = V::width;
+  size_t i = 0;
+  for (; i + W <= n; i += W)
+    F::store(out + i, Func(F::load(in + i)));
+  if (i < n) {
+    uint16_t tmp[W];
+    F::store(tmp, V::set1(1.0f));
+    for (size_t j = 0; j < n - i; j++)
+      tmp[j] = in[i + j];
+    F::store(tmp, Func(F::load(tmp)));
+    for (size_t j = 0; j < n - i; j++)
+      out[i + j] = tmp[j];
+  }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+//Batch normalization of 3D / 4D float vectors: v := v * rsqrt(dot(v, v)).
+//Dot product, rsqrt kernel and scaling are fused in one loop.
+//SoA: each component is in its own array, vectors are normalized in-place.
+//AoS: vectors are stored as consecutive triples / quadruples of floats;
+//V::width vectors are loaded and transposed to SoA in registers, then transposed back.
+//Zero vectors stay zero: squared length is clamped from below by FLT_MIN before rsqrt,
+//so scale is finite (vectors with squared length below FLT_MIN are not normalized properly).
+
+#include <cfloat>
+#include "vector_traits.h"
+
+//operations within 128-bit lanes of float vectors, used for AoS transposition;
+//lane k of register is loaded from p + 4 * stride * k, i.e. it holds floats p[4 stride k .. 4 stride k + 3]
+template<class V> struct FloatLanes;
+
+template<> struct FloatLanes<float4> {
+  typedef __m128 vec;
+  static FORCEINLINE vec load(const float *p, int) { return _mm_loadu_ps(p); }
+  static FORCEINLINE void store(float *p, int, vec x) { _mm_storeu_ps(p, x); }
+  static FORCEINLINE vec unpacklo(vec a, vec b) { return _mm_unpacklo_ps(a, b); }
+  static FORCEINLINE vec unpackhi(vec a, vec b) { return _mm_unpackhi_ps(a, b); }
+  template<int Imm> static FORCEINLINE vec shuffle(vec a, vec b) { return _mm_shuffle_ps(a, b, Imm); }
+};
+
+#ifdef __AVX__
+template<> struct FloatLanes<float8> {
+  typedef __m256 vec;
+  static FORCEINLINE vec load(const float *p, int stride) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 4 * stride), 1);
+  }
+  static FORCEINLINE void store(float *p, int stride, vec x) {
+    _mm_storeu_ps(p, _mm256_castps256_ps128(x));
+    _mm_storeu_ps(p + 4 * stride, _mm256_extractf128_ps(x, 1));
+  }
+  static FORCEINLINE vec unpacklo(vec a, vec b) { return _mm256_unpacklo_ps(a, b); }
+  static FORCEINLINE vec unpackhi(vec a, vec b) { return _mm256_unpackhi_ps(a, b); }
+  template<int Imm> static FORCEINLINE vec shuffle(vec a, vec b) { return _mm256_shuffle_ps(a, b, Imm); }
+};
+#endif
+
+#ifdef __AVX512F__
+template<> struct FloatLanes<float16> {
+  typedef __m512 vec;
+  static FORCEINLINE vec load(const float *p, int stride) {
+    vec res = _mm512_castps128_ps512(_mm_loadu_ps(p));
+    res = _mm512_insertf32x4(res, _mm_loadu_ps(p + 4 * stride), 1);
+    res = _mm512_insertf32x4(res, _mm_loadu_ps(p + 8 * stride), 2);
+    return _mm512_insertf32x4(res, _mm_loadu_ps(p + 12 * stride), 3);
+  }
+  static FORCEINLINE void store(float *p, int stride, vec x) {
+    _mm_storeu_ps(p, _mm512_castps512_ps128(x));
+    _mm_storeu_ps(p + 4 * stride, _mm512_extractf32x4_ps(x, 1));
+    _mm_storeu_ps(p + 8 * stride, _mm512_extractf32x4_ps(x, 2));
+    _mm_storeu_ps(p + 12 * stride, _mm512_extractf32x4_ps(x, 3));
+  }
+  static FORCEINLINE vec unpacklo(vec a, vec b) { return _mm512_unpacklo_ps(a, b); }
+  static FORCEINLINE vec unpackhi(vec a, vec b) { return _mm512_unpackhi_ps(a, b); }
+  template<int Imm> static FORCEINLINE vec shuffle(vec a, vec b) { return _mm512_shuffle_ps(a, b, Imm); }
+};
+#endif
+
+//V::width vectors of Dim floats at p <-> Dim registers of components (in every lane, 4 vectors are transposed)
+template<class V, int Dim> struct AosTranspose;
+
+template<class V> struct AosTranspose<V, 4> {
+  typedef FloatLanes<V> L;
+  typedef typename V::vec vec;
+  //4x4 transpose is an involution
+  static FORCEINLINE void transpose(vec *r) {
+    vec t0 = L::unpacklo(r[0], r[1]);     //x0 x1 y0 y1
+    vec t1 = L::unpacklo(r[2], r[3]);     //x2 x3 y2 y3
+    vec t2 = L::unpackhi(r[0], r[1]);     //z0 z1 w0 w1
+    vec t3 = L::unpackhi(r[2], r[3]);     //z2 z3 w2 w3
+    r[0] = L::template shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(t0, t1);
+    r[1] = L::template shuffle<_MM_SHUFFLE(3, 2, 3, 2)>(t0, t1);
+    r[2] = L::template shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(t2, t3);
+    r[3] = L::template shuffle<_MM_SHUFFLE(3, 2, 3, 2)>(t2, t3);
+  }
+  static FORCEINLINE void load(const float *p, vec *c) {
+    for (int j = 0; j < 4; j++)
+      c[j] = L::load(p + 4 * j, 4);
+    transpose(c);
+  }
+  static FORCEINLINE void store(float *p, vec *c) {
+    transpose(c);
+    for (int j = 0; j < 4; j++)
+      L::store(p + 4 * j, 4, c[j]);
+  }
+};
+
+template<class V> struct AosTranspose<V, 3> {
+  typedef FloatLanes<V> L;
+  typedef typename V::vec vec;
+  static FORCEINLINE void load(const float *p, vec *c) {
+    vec r0 = L::load(p, 3);         //x0 y0 z0 x1
+    vec r1 = L::load(p + 4, 3);     //y1 z1 x2 y2
+    vec r2 = L::load(p + 8, 3);     //z2 x3 y3 z3
+    vec xy = L::template shuffle<_MM_SHUFFLE(2, 1, 3, 2)>(r1, r2);    //x2 y2 x3 y3
+    vec yz = L::template shuffle<_MM_SHUFFLE(1, 0, 2, 1)>(r0, r1);    //y0 z0 y1 z1
+    c[0] = L::template shuffle<_MM_SHUFFLE(2, 0, 3, 0)>(r0, xy);
+    c[1] = L::template shuffle<_MM_SHUFFLE(3, 1, 2, 0)>(yz, xy);
+    c[2] = L::template shuffle<_MM_SHUFFLE(3, 0, 3, 1)>(yz, r2);
+  }
+  static FORCEINLINE void store(float *p, vec *c) {
+    vec xy0 = L::unpacklo(c[0], c[1]);                                 //x0 y0 x1 y1
+    vec xy1 = L::unpackhi(c[0], c[1]);                                 //x2 y2 x3 y3
+    vec zx = L::template shuffle<_MM_SHUFFLE(3, 1, 1, 0)>(c[2], c[0]);  //z0 z1 x1 x3
+    vec yz = L::template shuffle<_MM_SHUFFLE(3, 1, 3, 1)>(c[1], c[2]);  //y1 y3 z1 z3
+    vec zx2 = L::template shuffle<_MM_SHUFFLE(3, 3, 2, 2)>(c[2], c[0]); //z2 z2 x3 x3
+    L::store(p, 3, L::template shuffle<_MM_SHUFFLE(2, 0, 1, 0)>(xy0, zx));
+    L::store(p + 4, 3, L::template shuffle<_MM_SHUFFLE(1, 0, 2, 0)>(yz, xy1));
+    L::store(p + 8, 3, L::template shuffle<_MM_SHUFFLE(3, 1, 2, 0)>(zx2, yz));
+  }
+};
+
+//scales components c[0..Dim) by reciprocal length
+template<class V, typename V::vec (*Rsqrt)(typename V::vec), int Dim>
+static FORCEINLINE void normalize_components(typename V::vec *c) {
+  typename V::vec dot = V::mul(c[0], c[0]);
+  for (int k = 1; k < Dim; k++)
+    dot = V::fmadd(c[k], c[k], dot);
+  typename V::vec scale = Rsqrt(V::max(dot, V::set1(FLT_MIN)));
+  for (int k = 0; k < Dim; k++)
+    c[k] = V::mul(c[k], scale);
+}
+
+//comps[k] is array of k-th components of n vectors
+template<class V, typename V::vec (*Rsqrt)(typename V::vec), int Dim>
+static void normalize_soa(float *const *comps, size_t n) {
+  typedef typename V::vec vec;
+  const size_t W = V::width;
+  vec c[Dim];
+  size_t i = 0;
+  for (; i + W <= n; i += W) {
+    for (int k = 0; k < Dim; k++)
+      c[k] = V::loadu(comps[k] + i);
+    normalize_components<V, Rsqrt, Dim>(c);
+    for (int k = 0; k < Dim; k++)
+      V::storeu(comps[k] + i, c[k]);
+  }
+  if (i < n) {
+    for (int k = 0; k < Dim; k++)
+      c[k] = V::load_partial(comps[k] + i, n - i);
+    normalize_components<V, Rsqrt, Dim>(c);
+    for (int k = 0; k < Dim; k++)
+      V::store_partial(comps[k] + i, n - i, c[k]);
+  }
+}
+
+//in and out hold n vectors of Dim floats each, out must either be equal to in or not overlap it
+template<class V, typename V::vec (*Rsqrt)(typename V::vec), int Dim>
+static void normalize_aos(float *out, const float *in, size_t n) {
+  typedef typename V::vec vec;
+  const size_t W = V::width;
+  vec c[Dim];
+  size_t i = 0;
+  for (; i + W <= n; i += W) {
+    AosTranspose<V, Dim>::load(in + i * Dim, c);
+    normalize_components<V, Rsqrt, Dim>(c);
+    AosTranspose<V, Dim>::store(out + i * Dim, c);
+  }
+  if (i < n) {
+    //remaining vectors go through buffer, padded with zero vectors
+    float tmp[W * Dim];
+    for (size_t j = 0; j < W * Dim; j++)
+      tmp[j] = (j < (n - i) * Dim ? in[i * Dim + j] : 0.0f);
+    AosTranspose<V, Dim>::load(tmp, c);
+    normalize_components<V, Rsqrt, Dim>(c);
+    AosTranspose<V, Dim>::store(tmp, c);
+    for (size_t j = 0; j < (n - i) * Dim; j++)
+      out[i * Dim + j] = tmp[j];
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+//Parallel array drivers: array is split into contiguous chunks, one per thread of ThreadPool,
+//with boundaries on 4 KB pages of output, and each chunk is processed by apply_array.
+//first_touch writes arrays with the same split, so when arrays are allocated with FirstTouchAllocator
+//(pages are not touched on allocation) and pool threads are pinned, on NUMA systems every page
+//is placed on the node of the thread which processes it. Without libnuma, this is the only placement control.
+
+#include <stddef.h>
+#include <algorithm>
+#include "thread_pool.h"
+#include "array_kernels.h"
+
+//[begin, end) of chunk of given thread
+static inline void parallel_chunk(size_t n, size_t elemSize, int thread, int threads, size_t &begin, size_t &end) {
+  size_t pageElems = 4096 / elemSize;
+  size_t pages = (n + pageElems - 1) / pageElems;
+  begin = std::min(n, pages * thread / threads * pageElems);
+  end = std::min(n, pages * (thread + 1) / threads * pageElems);
+}
+
+//out[i] = gen(i) for all i, written by the thread which owns chunk with element i
+template<class T, class Gen>
+static void first_touch(ThreadPool &pool, T *out, size_t n, Gen gen) {
+  pool.run([&](int thread) {
+    size_t begin, end;
+    parallel_chunk(n, sizeof(T), thread, pool.size(), begin, end);
+    for (size_t i = begin; i < end; i++)
+      out[i] = gen(i);
+  });
+}
+
+//the same as apply_array, decision on non-temporal stores is made by the size of the whole output
+template<class V, typename V::vec (*Func)(typename V::vec)>
+static void parallel_apply_array(ThreadPool &pool, typename V::elem *out, const typename V::elem *in, size_t n, size_t stream_threshold = size_t(-1)) {
+  typedef typename V::elem elem;
+  size_t threshold = (n * sizeof(elem) > stream_threshold ? 0 : size_t(-1));
+  pool.run([&](int thread) {
+    size_t begin, end;
+    parallel_chunk(n, sizeof(elem), thread, pool.size(), begin, end);
+    apply_array<V, Func>(out + begin, in + begin, end - begin, threshold);
+  });
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+//Hardware performance counters of the calling thread (user mode only):
+//core clock cycles, retired instructions and issued uops.
+//Implemented via perf_event_open on Linux. Elsewhere, or when access is not permitted
+//(e.g. perf_event_paranoid or a VM without virtual PMU), counters are unavailable
+//and callers should fall back to rdtsc.
+
+#include <string.h>
+#include "cpu_features.h"
+
+#ifdef __linux__
+  #include <unistd.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <linux/perf_event.h>
+#endif
+
+struct PerfCounts {
+  unsigned long long cycles;
+  unsigned long long instructions;  //0 if not available
+  unsigned long long uops;          //0 if not available
+};
+
+class PerfCounters {
+public:
+  enum { Cycles, Instructions, Uops, EventsNum };
+
+  PerfCounters() {
+    for (int e = 0; e < EventsNum; e++)
+      fds[e] = -1;
+#ifdef __linux__
+    fds[Cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (fds[Cycles] < 0)
+      return;
+    fds[Instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fds[Cycles]);
+    //uops have no generic event: use UOPS_ISSUED.ANY (event 0x0E, umask 0x01) on Intel
+    if (detect_cpu_features().intel)
+      fds[Uops] = open_event(PERF_TYPE_RAW, 0x010E, fds[Cycles]);
+    //some hypervisors accept events but never count them
+    start();
+    volatile int dummy = 0;
+    for (int i = 0; i < 1000; i++)
+      dummy += i;
+    if (stop().cycles == 0)
+      close_all();
+#endif
+  }
+  ~PerfCounters() {
+    close_all();
+  }
+
+  bool available() const { return fds[Cycles] >= 0; }
+  bool has_instructions() const { return fds[Instructions] >= 0; }
+  bool has_uops() const { return fds[Uops] >= 0; }
+
+  void start() {
+#ifdef __linux__
+    ioctl(fds[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  PerfCounts stop() {
+    PerfCounts res = {0, 0, 0};
+#ifdef __linux__
+    ioctl(fds[Cycles], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    //PERF_FORMAT_GROUP: number of events, then values in order of opening
+    unsigned long long data[1 + EventsNum];
+    if (read(fds[Cycles], data, sizeof(data)) <= 0)
+      return res;
+    unsigned long long *values[EventsNum] = {&res.cycles, &res.instructions, &res.uops};
+    for (int e = 0, k = 1; e < EventsNum && k <= int(data[0]); e++)
+      if (fds[e] >= 0)
+        *values[e] = data[k++];
+#endif
+    return res;
+  }
+
+private:
+  PerfCounters(const PerfCounters&);
+  PerfCounters &operator= (const PerfCounters&);
+
+#ifdef __linux__
+  static int open_event(unsigned type, unsigned long long config, int groupFd) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (groupFd < 0);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return int(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+  }
+#endif
+
+  void close_all() {
+#ifdef __linux__
+    for (int e = EventsNum - 1; e >= 0; e--)
+      if (fds[e] >= 0)
+        close(fds[e]);
+#endif
+    for (int e = 0; e < EventsNum; e++)
+      fds[e] = -1;
+  }
+
+  int fds[EventsNum];
+};
@@ -20,3 +20,35 @@
   }
   #endif
 #endif
+
+//Serialized versions for timing a region of code:
+//  rdtsc_begin waits for all previous instructions to complete before reading TSC,
+//  rdtsc_end waits for all timed instructions to complete, and prevents later ones from starting early.
+//see "How to Benchmark Code Execution Times on Intel IA-32 and IA-64 Instruction Set Architectures"
+#if defined(_MSC_VER)
+  static __forceinline unsigned long long rdtsc_begin() {
+    _mm_lfence();
+    unsigned long long res = __rdtsc();
+    _mm_lfence();
+    return res;
+  }
+  static __forceinline unsigned long long rdtsc_end() {
+    unsigned aux;
+    unsigned long long res = __rdtscp(&aux);
+    _mm_lfence();
+    return res;
+  }
+#elif defined(__GNUC__) || defined(__clang__)
+  static __inline__ unsigned long long rdtsc_begin(void)
+  {
+      unsigned hi, lo;
+      __asm__ __volatile__ ("lfence\n\trdtsc\n\tlfence" : "=a"(lo), "=d"(hi) :: "memory");
+      return ( (unsigned long long)lo)|( ((unsigned long long)hi)<<32 );
+  }
+  static __inline__ unsigned long long rdtsc_end(void)
+  {
+      unsigned hi, lo;
+      __asm__ __volatile__ ("rdtscp\n\tlfence" : "=a"(lo), "=d"(hi) :: "rcx", "memory");
+      return ( (unsigned long long)lo)|( ((unsigned long long)hi)<<32 );
+  }
+#endif
@@ -0,0 +1,267 @@
+//runtime dispatcher for recip_rsqrt.h
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "recip_rsqrt.h"
+#include "recip_rsqrt_impl.h"
+#include "cpu_features.h"
+
+static const RecipRsqrtKernels *active_isa = 0;    //table of selected instruction set
+static RecipRsqrtKernels active_kernels;           //its copy with tuning applied
+size_t streaming_threshold_bytes = size_t(-1);
+
+//line of tuning file
+struct TuningEntry {
+  char isa[16], function[16], type[16], kernel[64];
+  PrecisionTier tier;
+};
+//function-local static, because library may be initialized from other static initializers
+static std::vector<TuningEntry> &tuning_entries() {
+  static std::vector<TuningEntry> entries;
+  return entries;
+}
+
+static bool is_supported(const RecipRsqrtKernels *kernels, const CpuFeatures &cpu) {
+  if (kernels == &recip_rsqrt_kernels_avx512)
+    return cpu.avx512f;
+  if (kernels == &recip_rsqrt_kernels_avx2)
+    return cpu.avx2 && cpu.fma;
+  return cpu.sse2;
+}
+
+static const RecipRsqrtKernels *const all_kernels[] = {
+  //sorted from the best to the worst
+  &recip_rsqrt_kernels_avx512,
+  &recip_rsqrt_kernels_avx2,
+  &recip_rsqrt_kernels_sse2,
+};
+
+static const RecipRsqrtKernels *select_kernels() {
+  CpuFeatures cpu = detect_cpu_features();
+  for (size_t i = 0; i < sizeof(all_kernels) / sizeof(all_kernels[0]); i++)
+    if (is_supported(all_kernels[i], cpu))
+      return all_kernels[i];
+  //SSE2 is always present on x86-64
+  return &recip_rsqrt_kernels_sse2;
+}
+
+//copies table of instruction set and applies tuning entries for it
+static void activate(const RecipRsqrtKernels *isa) {
+  active_isa = isa;
+  active_kernels = *isa;
+  const std::vector<TuningEntry> &entries = tuning_entries();
+  for (size_t i = 0; i < entries.size(); i++) {
+    const TuningEntry &e = entries[i];
+    if (strcmp(e.isa, isa->isa) == 0)
+      recip_rsqrt_select_kernel(e.function, e.type, e.tier, e.kernel);
+  }
+}
+
+static void initialize() {
+  activate(select_kernels());
+  size_t cacheSize = detect_last_level_cache_size();
+  streaming_threshold_bytes = (cacheSize > 0 ? cacheSize : size_t(8) << 20);
+  const char *path = getenv("RECIP_RSQRT_TUNING");
+  recip_rsqrt_load_tuning(path ? path : "recip_rsqrt.tune");
+}
+
+static inline RecipRsqrtKernels *kernels() {
+  //normally initialized at startup, but may be called from other static initializers
+  if (!active_isa)
+    initialize();
+  return &active_kernels;
+}
+
+static struct RecipRsqrtInitializer {
+  RecipRsqrtInitializer() { kernels(); }
+} recip_rsqrt_initializer;
+
+void recip(float *out, const float *in, size_t n, PrecisionTier tier) {
+  kernels()->recip_float[int(tier)](out, in, n);
+}
+void recip(double *out, const double *in, size_t n, PrecisionTier tier) {
+  kernels()->recip_double[int(tier)](out, in, n);
+}
+void rsqrt(float *out, const float *in, size_t n, PrecisionTier tier) {
+  kernels()->rsqrt_float[int(tier)](out, in, n);
+}
+void rsqrt(double *out, const double *in, size_t n, PrecisionTier tier) {
+  kernels()->rsqrt_double[int(tier)](out, in, n);
+}
+
+void recip_rsqrt_div(float *out, const float *a, const float *b, size_t n, PrecisionTier tier) {
+  kernels()->div_float[int(tier)](out, a, b, n);
+}
+void recip_rsqrt_div(double *out, const double *a, const double *b, size_t n, PrecisionTier tier) {
+  kernels()->div_double[int(tier)](out, a, b, n);
+}
+void recip_rsqrt_sqrt(float *out, const float *in, size_t n, PrecisionTier tier) {
+  kernels()->sqrt_float[int(tier)](out, in, n);
+}
+void recip_rsqrt_sqrt(double *out, const double *in, size_t n, PrecisionTier tier) {
+  kernels()->sqrt_double[int(tier)](out, in, n);
+}
+
+void normalize3(float *x, float *y, float *z, size_t n, PrecisionTier tier) {
+  float *const comps[3] = {x, y, z};
+  kernels()->normalize3_soa[int(tier)](comps, n);
+}
+void normalize4(float *x, float *y, float *z, float *w, size_t n, PrecisionTier tier) {
+  float *const comps[4] = {x, y, z, w};
+  kernels()->normalize4_soa[int(tier)](comps, n);
+}
+void normalize3(float *out, const float *in, size_t n, PrecisionTier tier) {
+  kernels()->normalize3_aos[int(tier)](out, in, n);
+}
+void normalize4(float *out, const float *in, size_t n, PrecisionTier tier) {
+  kernels()->normalize4_aos[int(tier)](out, in, n);
+}
+
+const char *recip_rsqrt_isa() {
+  return kernels()->isa;
+}
+
+bool recip_rsqrt_select_isa(const char *isa) {
+  kernels();
+  CpuFeatures cpu = detect_cpu_features();
+  for (size_t i = 0; i < sizeof(all_kernels) / sizeof(all_kernels[0]); i++)
+    if (strcmp(all_kernels[i]->isa, isa) == 0) {
+      if (!is_supported(all_kernels[i], cpu))
+        return false;
+      activate(all_kernels[i]);
+      return true;
+    }
+  return false;
+}
+
+size_t recip_rsqrt_streaming_threshold() {
+  kernels();
+  return streaming_threshold_bytes;
+}
+
+void recip_rsqrt_set_streaming_threshold(size_t bytes) {
+  kernels();
+  streaming_threshold_bytes = bytes;
+}
+
+size_t recip_rsqrt_cache_size(int level) {
+  return level > 0 ? detect_cache_size(level) : 0;
+}
+
+//================ Tuning ===============
+
+//dispatch entries and candidates of one function for one element type
+template<class T> struct KernelFamily {
+  void (**tiers)(T *out, const T *in, size_t n);
+  const NamedKernel<T> *candidates;
+};
+
+static bool parse_family(const char *function, const char *type, bool &rsqrt, bool &isDouble) {
+  rsqrt = (strcmp(function, "rsqrt") == 0);
+  isDouble = (strcmp(type, "double") == 0);
+  return (rsqrt || strcmp(function, "recip") == 0) && (isDouble || strcmp(type, "float") == 0);
+}
+static KernelFamily<float> float_family(bool rsqrt) {
+  RecipRsqrtKernels *k = kernels();
+  KernelFamily<float> res = {rsqrt ? k->rsqrt_float : k->recip_float, rsqrt ? k->rsqrt_float_candidates : k->recip_float_candidates};
+  return res;
+}
+static KernelFamily<double> double_family(bool rsqrt) {
+  RecipRsqrtKernels *k = kernels();
+  KernelFamily<double> res = {rsqrt ? k->rsqrt_double : k->recip_double, rsqrt ? k->rsqrt_double_candidates : k->recip_double_candidates};
+  return res;
+}
+
+template<class T> static int candidates_num(const KernelFamily<T> &family) {
+  int n = 0;
+  while (family.candidates[n].name)
+    n++;
+  return n;
+}
+template<class T> static const char *selected_name(const KernelFamily<T> &family, PrecisionTier tier) {
+  for (const NamedKernel<T> *c = family.candidates; c->name; c++)
+    if (c->func == family.tiers[int(tier)])
+      return c->name;
+  return 0;
+}
+template<class T> static bool select_candidate(const KernelFamily<T> &family, PrecisionTier tier, const char *kernel) {
+  for (const NamedKernel<T> *c = family.candidates; c->name; c++)
+    if (strcmp(c->name, kernel) == 0) {
+      family.tiers[int(tier)] = c->func;
+      return true;
+    }
+  return false;
+}
+
+int recip_rsqrt_candidates_num(const char *function, const char *type) {
+  bool rsqrt, isDouble;
+  if (!parse_family(function, type, rsqrt, isDouble))
+    return 0;
+  return isDouble ? candidates_num(double_family(rsqrt)) : candidates_num(float_family(rsqrt));
+}
+
+const char *recip_rsqrt_candidate_name(const char *function, const char *type, int index) {
+  if (index < 0 || index >= recip_rsqrt_candidates_num(function, type))
+    return 0;
+  bool rsqrt, isDouble;
+  parse_family(function, type, rsqrt, isDouble);
+  return isDouble ? double_family(rsqrt).candidates[index].name : float_family(rsqrt).candidates[index].name;
+}
+
+const char *recip_rsqrt_selected_kernel(const char *function, const char *type, PrecisionTier tier) {
+  bool rsqrt, isDouble;
+  if (!parse_family(function, type, rsqrt, isDouble))
+    return 0;
+  return isDouble ? selected_name(double_family(rsqrt), tier) : selected_name(float_family(rsqrt), tier);
+}
+
+bool recip_rsqrt_select_kernel(const char *function, const char *type, PrecisionTier tier, const char *kernel) {
+  bool rsqrt, isDouble;
+  if (!parse_family(function, type, rsqrt, isDouble))
+    return false;
+  return isDouble ? select_candidate(double_family(rsqrt), tier, kernel) : select_candidate(float_family(rsqrt), tier, kernel);
+}
+
+static const char *const tier_names[] = {"fast", "medium", "high", "exact"};
+
+const char *recip_rsqrt_tier_name(PrecisionTier tier) {
+  return tier_names[int(tier)];
+}
+
+bool recip_rsqrt_load_tuning(const char *path) {
+  kernels();
+  FILE *f = fopen(path, "r");
+  if (!f)
+    return false;
+  std::vector<TuningEntry> entries;
+  bool ok = true;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    if (char *comment = strchr(line, '#'))
+      *comment = 0;
+    TuningEntry e;
+    char tier[16];
+    int fields = sscanf(line, "%15s %15s %15s %15s %63s", e.isa, e.function, e.type, tier, e.kernel);
+    if (fields <= 0)
+      continue;    //empty line
+    if (fields != 5) {
+      ok = false;
+      continue;
+    }
+    int t = 0;
+    while (t < 4 && strcmp(tier, tier_names[t]) != 0)
+      t++;
+    bool rsqrt, isDouble;
+    if (t == 4 || !parse_family(e.function, e.type, rsqrt, isDouble)) {
+      ok = false;
+      continue;
+    }
+    e.tier = PrecisionTier(t);
+    entries.push_back(e);
+  }
+  fclose(f);
+  tuning_entries() = entries;
+  activate(active_isa);
+  return ok;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+//Bulk recip(x) = 1 / x and rsqrt(x) = 1 / sqrt(x) (also a / b, sqrt(x) and vector normalization) with runtime dispatch.
+//The best instruction set (SSE2, AVX2+FMA, AVX-512) is detected via CPUID at startup,
+//and the chosen kernels are cached in function pointers.
+//Kernel of each tier can be overridden by tuning file (see recip_rsqrt_load_tuning).
+//Arrays need not be aligned. Output must either be equal to input or not overlap it.
+
+#include <stddef.h>
+
+//error budgets below are used by autotuning (see --autotune in main.cpp)
+enum class PrecisionTier {
+  Fast,     //raw hardware approximation: ~12 bits (~14 bits on AVX-512), relative error below 2^-11
+  Medium,   //about single precision: relative error below 5e-7
+  High,     //almost full precision of the type: error within 4 ulps
+  Exact,    //IEEE division and square root (recip is correctly rounded), never changed by autotuning
+};
+
+void recip(float *out, const float *in, size_t n, PrecisionTier tier = PrecisionTier::High);
+void recip(double *out, const double *in, size_t n, PrecisionTier tier = PrecisionTier::High);
+void rsqrt(float *out, const float *in, size_t n, PrecisionTier tier = PrecisionTier::High);
+void rsqrt(double *out, const double *in, size_t n, PrecisionTier tier = PrecisionTier::High);
+
+//Division out = a / b and square root out = sqrt(in), computed from recip / rsqrt approximations
+//(prefixed, so that they do not overload ::div and ::sqrt from the C library)
+//with numerator folded into the last correction (tuning of recip / rsqrt does not affect them).
+//Exact tier uses IEEE division and square root. sqrt(0) = 0 in all tiers.
+//Output may be equal to any input.
+void recip_rsqrt_div(float *out, const float *a, const float *b, size_t n, PrecisionTier tier = PrecisionTier::High);
+void recip_rsqrt_div(double *out, const double *a, const double *b, size_t n, PrecisionTier tier = PrecisionTier::High);
+void recip_rsqrt_sqrt(float *out, const float *in, size_t n, PrecisionTier tier = PrecisionTier::High);
+void recip_rsqrt_sqrt(double *out, const double *in, size_t n, PrecisionTier tier = PrecisionTier::High);
+
+//Normalization of float vectors: v := v / |v|, with 1/|v| computed by rsqrt of given tier
+//(kernels are fused, so tuning of rsqrt does not affect them). Zero vectors stay zero.
+//SoA: k-th components of n vectors are in k-th array, vectors are normalized in-place.
+void normalize3(float *x, float *y, float *z, size_t n, PrecisionTier tier = PrecisionTier::High);
+void normalize4(float *x, float *y, float *z, float *w, size_t n, PrecisionTier tier = PrecisionTier::High);
+//AoS: n vectors of 3 (or 4) consecutive floats. Output must either be equal to input or not overlap it.
+void normalize3(float *out, const float *in, size_t n, PrecisionTier tier = PrecisionTier::High);
+void normalize4(float *out, const float *in, size_t n, PrecisionTier tier = PrecisionTier::High);
+
+//name of currently used instruction set: "sse2", "avx2" or "avx512"
+const char *recip_rsqrt_isa();
+//force given instruction set (e.g. for benchmarking)
+//returns false if it is unknown or not supported by CPU
+bool recip_rsqrt_select_isa(const char *isa);
+
+//output arrays larger than this (in bytes) are written with non-temporal stores
+//by default it is equal to the size of last level cache
+size_t recip_rsqrt_streaming_threshold();
+void recip_rsqrt_set_streaming_threshold(size_t bytes);
+//size of data cache of given level (1, 2, 3) in bytes, 0 if unknown
+size_t recip_rsqrt_cache_size(int level);
+
+//Tuning: every function, element type and tier may use any candidate kernel of the current instruction set.
+//Function is "recip" or "rsqrt", type is "float" or "double", kernel is a short name (e.g. "r5", see recip_rsqrt_<isa>.cpp).
+//Changing kernels is not thread-safe with concurrent calls.
+
+//number of candidate kernels on current instruction set, and name of index-th of them (null if out of range)
+int recip_rsqrt_candidates_num(const char *function, const char *type);
+const char *recip_rsqrt_candidate_name(const char *function, const char *type, int index);
+//name of kernel currently used, null if function or type is unknown
+const char *recip_rsqrt_selected_kernel(const char *function, const char *type, PrecisionTier tier);
+//uses given candidate kernel until instruction set is changed, returns false if there is no such kernel
+bool recip_rsqrt_select_kernel(const char *function, const char *type, PrecisionTier tier, const char *kernel);
+
+//"fast", "medium", "high" or "exact"
+const char *recip_rsqrt_tier_name(PrecisionTier tier);
+
+//Tuning file has lines "isa function type tier kernel", e.g. "avx2 recip double high r4"; '#' starts a comment.
+//Entries of an instruction set are applied whenever it is selected (at startup or by recip_rsqrt_select_isa).
+//At startup, file named by environment variable RECIP_RSQRT_TUNING is loaded,
+//or "recip_rsqrt.tune" from current directory if the variable is not set.
+//Loading replaces all previous entries. Returns false if file cannot be read or has malformed lines.
+bool recip_rsqrt_load_tuning(const char *path);
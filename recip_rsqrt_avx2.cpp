@@ -0,0 +1,107 @@
+//bulk kernels for AVX2 + FMA
+//must be compiled with -mavx2 -mfma (GCC, Clang) or /arch:AVX2 (MSVC)
+#include <immintrin.h>
+#include "compiler.h"
+#include "recip_rsqrt_impl.h"
+#include "routines_avx.h"
+#include "routines_table.h"
+#include "corrector.h"
+
+static const NamedKernel<float> recip_float_candidates[] = {
+  {"fast", bulk_kernel<float8, recip_float8_fast>},
+  {"nr1", bulk_kernel<float8, recip_float8_nr1>},
+  {"minimax2", MINIMAX_KERNEL(recip, Recip, float8, 2)},
+  {"ieee", bulk_kernel<float8, recip_float8_ieee>},
+  {0, 0}
+};
+static const NamedKernel<double> recip_double_candidates[] = {
+  {"fast", bulk_kernel<double4, recip_double4_fast>},
+  {"nr1", bulk_kernel<double4, recip_double4_nr1>},
+  {"nr2", bulk_kernel<double4, recip_double4_nr2>},
+  {"r3", bulk_kernel<double4, recip_double4_r3>},
+  {"r4", bulk_kernel<double4, recip_double4_r4>},
+  {"r5", bulk_kernel<double4, recip_double4_r5>},
+  {"magic_r5", bulk_kernel<double4, recip_double4_magic_r5>},
+  {"table8_r3", bulk_kernel<double4, recip_double4_table_r3<8>>},
+  {"minimax3", MINIMAX_KERNEL(recip, Recip, double4, 3)},
+  {"minimax4", MINIMAX_KERNEL(recip, Recip, double4, 4)},
+  {"minimax5", MINIMAX_KERNEL(recip, Recip, double4, 5)},
+  {"ieee", bulk_kernel<double4, recip_double4_ieee>},
+  {0, 0}
+};
+static const NamedKernel<float> rsqrt_float_candidates[] = {
+  {"fast", bulk_kernel<float8, rsqrt_float8_fast>},
+  {"nr1", bulk_kernel<float8, rsqrt_float8_nr1>},
+  {"minimax2", MINIMAX_KERNEL(rsqrt, Rsqrt, float8, 2)},
+  {"ieee", bulk_kernel<float8, rsqrt_float8_ieee>},
+  {0, 0}
+};
+static const NamedKernel<double> rsqrt_double_candidates[] = {
+  {"fast", bulk_kernel<double4, rsqrt_double4_fast>},
+  {"nr1", bulk_kernel<double4, rsqrt_double4_nr1>},
+  {"nr2", bulk_kernel<double4, rsqrt_double4_nr2>},
+  {"r2", bulk_kernel<double4, rsqrt_double4_r2>},
+  {"r3", bulk_kernel<double4, rsqrt_double4_r3>},
+  {"r4", bulk_kernel<double4, rsqrt_double4_r4>},
+  {"r5", bulk_kernel<double4, rsqrt_double4_r5>},
+  {"magic_r5", bulk_kernel<double4, rsqrt_double4_magic_r5>},
+  {"table8_r3", bulk_kernel<double4, rsqrt_double4_table_r3<8>>},
+  {"minimax3", MINIMAX_KERNEL(rsqrt, Rsqrt, double4, 3)},
+  {"minimax4", MINIMAX_KERNEL(rsqrt, Rsqrt, double4, 4)},
+  {"minimax5", MINIMAX_KERNEL(rsqrt, Rsqrt, double4, 5)},
+  {"ieee", bulk_kernel<double4, rsqrt_double4_ieee>},
+  {0, 0}
+};
+
+extern const RecipRsqrtKernels recip_rsqrt_kernels_avx2 = {
+  "avx2",
+  //Fast, Medium, High, Exact
+  {
+    bulk_kernel<float8, recip_float8_fast>,
+    bulk_kernel<float8, recip_float8_nr1>,
+    bulk_kernel<float8, recip_float8_nr1>,
+    bulk_kernel<float8, recip_float8_ieee>,
+  }, {
+    bulk_kernel<double4, recip_double4_fast>,
+    bulk_kernel<double4, recip_double4_nr1>,
+    bulk_kernel<double4, recip_double4_r5>,
+    bulk_kernel<double4, recip_double4_ieee>,
+  }, {
+    bulk_kernel<float8, rsqrt_float8_fast>,
+    bulk_kernel<float8, rsqrt_float8_nr1>,
+    bulk_kernel<float8, rsqrt_float8_nr1>,
+    bulk_kernel<float8, rsqrt_float8_ieee>,
+  }, {
+    bulk_kernel<double4, rsqrt_double4_fast>,
+    bulk_kernel<double4, rsqrt_double4_nr1>,
+    bulk_kernel<double4, rsqrt_double4_r5>,
+    bulk_kernel<double4, rsqrt_double4_ieee>,
+  },
+  recip_float_candidates, recip_double_candidates,
+  rsqrt_float_candidates, rsqrt_double_candidates,
+  NORMALIZE_TIERS(normalize_soa, float8, 3),
+  NORMALIZE_TIERS(normalize_soa, float8, 4),
+  NORMALIZE_TIERS(normalize_aos, float8, 3),
+  NORMALIZE_TIERS(normalize_aos, float8, 4),
+  {
+    bulk_kernel2<float8, div_float8_fast>,
+    bulk_kernel2<float8, div_float8_nr1>,
+    bulk_kernel2<float8, div_float8_nr1>,
+    bulk_kernel2<float8, div_float8_ieee>,
+  }, {
+    bulk_kernel2<double4, div_double4_fast>,
+    bulk_kernel2<double4, div_double4_nr1>,
+    bulk_kernel2<double4, div_double4_r3>,
+    bulk_kernel2<double4, div_double4_ieee>,
+  }, {
+    bulk_kernel<float8, sqrt_float8_fast>,
+    bulk_kernel<float8, sqrt_float8_nr1>,
+    bulk_kernel<float8, sqrt_float8_nr1>,
+    bulk_kernel<float8, sqrt_float8_ieee>,
+  }, {
+    bulk_kernel<double4, sqrt_double4_fast>,
+    bulk_kernel<double4, sqrt_double4_nr1>,
+    bulk_kernel<double4, sqrt_double4_r3>,
+    bulk_kernel<double4, sqrt_double4_ieee>,
+  },
+};
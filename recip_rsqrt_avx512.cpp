@@ -0,0 +1,90 @@
+//bulk kernels for AVX-512F
+//must be compiled with -mavx512f (GCC, Clang) or /arch:AVX512 (MSVC)
+#include <immintrin.h>
+#include "compiler.h"
+#include "recip_rsqrt_impl.h"
+#include "routines_avx512.h"
+#include "corrector.h"
+
+//minimax coefficients are fitted for 12-bit seeds, so only Taylor correctors are offered here
+static const NamedKernel<float> recip_float_candidates[] = {
+  {"fast", bulk_kernel<float16, recip_float16_fast>},
+  {"nr1", bulk_kernel<float16, recip_float16_nr1>},
+  {"ieee", bulk_kernel<float16, recip_float16_ieee>},
+  {0, 0}
+};
+static const NamedKernel<double> recip_double_candidates[] = {
+  {"fast", bulk_kernel<double8, recip_double8_fast>},
+  {"nr1", bulk_kernel<double8, recip_double8_nr1>},
+  {"r3", bulk_kernel<double8, corrected<double8, recip_double8_fast, CorrectorFunc::Recip, 3, PolyScheme::Horner>>},
+  {"r4", bulk_kernel<double8, recip_double8_r4>},
+  {"ieee", bulk_kernel<double8, recip_double8_ieee>},
+  {0, 0}
+};
+static const NamedKernel<float> rsqrt_float_candidates[] = {
+  {"fast", bulk_kernel<float16, rsqrt_float16_fast>},
+  {"nr1", bulk_kernel<float16, rsqrt_float16_nr1>},
+  {"ieee", bulk_kernel<float16, rsqrt_float16_ieee>},
+  {0, 0}
+};
+static const NamedKernel<double> rsqrt_double_candidates[] = {
+  {"fast", bulk_kernel<double8, rsqrt_double8_fast>},
+  {"nr1", bulk_kernel<double8, rsqrt_double8_nr1>},
+  {"r3", bulk_kernel<double8, corrected<double8, rsqrt_double8_fast, CorrectorFunc::Rsqrt, 3, PolyScheme::Horner>>},
+  {"r4", bulk_kernel<double8, rsqrt_double8_r4>},
+  {"ieee", bulk_kernel<double8, rsqrt_double8_ieee>},
+  {0, 0}
+};
+
+extern const RecipRsqrtKernels recip_rsqrt_kernels_avx512 = {
+  "avx512",
+  //Fast, Medium, High, Exact
+  {
+    bulk_kernel<float16, recip_float16_fast>,
+    bulk_kernel<float16, recip_float16_nr1>,
+    bulk_kernel<float16, recip_float16_nr1>,
+    bulk_kernel<float16, recip_float16_ieee>,
+  }, {
+    bulk_kernel<double8, recip_double8_fast>,
+    bulk_kernel<double8, recip_double8_nr1>,
+    bulk_kernel<double8, recip_double8_r4>,
+    bulk_kernel<double8, recip_double8_ieee>,
+  }, {
+    bulk_kernel<float16, rsqrt_float16_fast>,
+    bulk_kernel<float16, rsqrt_float16_nr1>,
+    bulk_kernel<float16, rsqrt_float16_nr1>,
+    bulk_kernel<float16, rsqrt_float16_ieee>,
+  }, {
+    bulk_kernel<double8, rsqrt_double8_fast>,
+    bulk_kernel<double8, rsqrt_double8_nr1>,
+    bulk_kernel<double8, rsqrt_double8_r4>,
+    bulk_kernel<double8, rsqrt_double8_ieee>,
+  },
+  recip_float_candidates, recip_double_candidates,
+  rsqrt_float_candidates, rsqrt_double_candidates,
+  NORMALIZE_TIERS(normalize_soa, float16, 3),
+  NORMALIZE_TIERS(normalize_soa, float16, 4),
+  NORMALIZE_TIERS(normalize_aos, float16, 3),
+  NORMALIZE_TIERS(normalize_aos, float16, 4),
+  {
+    bulk_kernel2<float16, div_float16_fast>,
+    bulk_kernel2<float16, div_float16_nr1>,
+    bulk_kernel2<float16, div_float16_nr1>,
+    bulk_kernel2<float16, div_float16_ieee>,
+  }, {
+    bulk_kernel2<double8, div_double8_fast>,
+    bulk_kernel2<double8, div_double8_nr1>,
+    bulk_kernel2<double8, div_double8_nr2>,
+    bulk_kernel2<double8, div_double8_ieee>,
+  }, {
+    bulk_kernel<float16, sqrt_float16_fast>,
+    bulk_kernel<float16, sqrt_float16_nr1>,
+    bulk_kernel<float16, sqrt_float16_nr1>,
+    bulk_kernel<float16, sqrt_float16_ieee>,
+  }, {
+    bulk_kernel<double8, sqrt_double8_fast>,
+    bulk_kernel<double8, sqrt_double8_nr1>,
+    bulk_kernel<double8, sqrt_double8_nr2>,
+    bulk_kernel<double8, sqrt_double8_ieee>,
+  },
+};
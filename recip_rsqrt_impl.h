@@ -0,0 +1,70 @@
+#pragma once
+
+//internal header: tables of bulk kernels for each instruction set
+//each table is defined in its own translation unit, compiled with its own ISA flags
+
+#include <stddef.h>
+#include "array_kernels.h"
+#include "normalize.h"
+
+//output arrays larger than this (in bytes) are written with non-temporal stores
+extern size_t streaming_threshold_bytes;
+
+//bulk version of vector kernel Func (see apply_array)
+template<class V, typename V::vec (*Func)(typename V::vec)>
+static void bulk_kernel(typename V::elem *out, const typename V::elem *in, size_t n) {
+  apply_array<V, Func>(out, in, n, streaming_threshold_bytes);
+}
+
+template<class V, typename V::vec (*Func)(typename V::vec, typename V::vec)>
+static void bulk_kernel2(typename V::elem *out, const typename V::elem *a, const typename V::elem *b, size_t n) {
+  apply_array2<V, Func>(out, a, b, n, streaming_threshold_bytes);
+}
+
+//bulk kernel: seed <function>_<vec>_fast followed by minimax corrector of given order (requires corrector.h)
+#define MINIMAX_KERNEL(function, Function, vec, order) \
+  bulk_kernel<vec, corrected_minimax<vec, function##_##vec##_fast, CorrectorFunc::Function, order, PolyScheme::Horner>>
+
+typedef void (*float_array_func)(float *out, const float *in, size_t n);
+typedef void (*double_array_func)(double *out, const double *in, size_t n);
+typedef void (*float_array2_func)(float *out, const float *a, const float *b, size_t n);
+typedef void (*double_array2_func)(double *out, const double *a, const double *b, size_t n);
+typedef void (*normalize_soa_func)(float *const *comps, size_t n);
+typedef void (*normalize_aos_func)(float *out, const float *in, size_t n);
+
+//normalization kernels for all tiers (Fast, Medium, High, Exact), layout is normalize_soa or normalize_aos
+#define NORMALIZE_TIERS(layout, vec, dim) { \
+  layout<vec, rsqrt_##vec##_fast, dim>, layout<vec, rsqrt_##vec##_nr1, dim>, \
+  layout<vec, rsqrt_##vec##_nr1, dim>, layout<vec, rsqrt_##vec##_ieee, dim> }
+
+//bulk kernel which can be chosen by tuning (see recip_rsqrt_select_kernel)
+template<class T> struct NamedKernel {
+  const char *name;
+  void (*func)(T *out, const T *in, size_t n);
+};
+
+//arrays of kernels are indexed by PrecisionTier,
+//arrays of candidates are terminated by null name and include all default kernels
+struct RecipRsqrtKernels {
+  const char *isa;
+  float_array_func recip_float[4];
+  double_array_func recip_double[4];
+  float_array_func rsqrt_float[4];
+  double_array_func rsqrt_double[4];
+  const NamedKernel<float> *recip_float_candidates;
+  const NamedKernel<double> *recip_double_candidates;
+  const NamedKernel<float> *rsqrt_float_candidates;
+  const NamedKernel<double> *rsqrt_double_candidates;
+  normalize_soa_func normalize3_soa[4];
+  normalize_soa_func normalize4_soa[4];
+  normalize_aos_func normalize3_aos[4];
+  normalize_aos_func normalize4_aos[4];
+  float_array2_func div_float[4];
+  double_array2_func div_double[4];
+  float_array_func sqrt_float[4];
+  double_array_func sqrt_double[4];
+};
+
+extern const RecipRsqrtKernels recip_rsqrt_kernels_sse2;    //recip_rsqrt_sse2.cpp
+extern const RecipRsqrtKernels recip_rsqrt_kernels_avx2;    //recip_rsqrt_avx2.cpp: -mavx2 -mfma
+extern const RecipRsqrtKernels recip_rsqrt_kernels_avx512;  //recip_rsqrt_avx512.cpp: -mavx512f
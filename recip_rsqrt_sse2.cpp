@@ -0,0 +1,103 @@
+//bulk kernels for SSE2 (baseline of x86-64, no special flags needed)
+#include <emmintrin.h>
+#include "compiler.h"
+#include "recip_rsqrt_impl.h"
+#include "routines_sse.h"
+#include "corrector.h"
+
+static const NamedKernel<float> recip_float_candidates[] = {
+  {"fast", bulk_kernel<float4, recip_float4_fast>},
+  {"nr1", bulk_kernel<float4, recip_float4_nr1>},
+  {"minimax2", MINIMAX_KERNEL(recip, Recip, float4, 2)},
+  {"ieee", bulk_kernel<float4, recip_float4_ieee>},
+  {0, 0}
+};
+static const NamedKernel<double> recip_double_candidates[] = {
+  {"fast", bulk_kernel<double2, recip_double2_fast>},
+  {"nr1", bulk_kernel<double2, recip_double2_nr1>},
+  {"nr2", bulk_kernel<double2, recip_double2_nr2>},
+  {"r3", bulk_kernel<double2, recip_double2_r3>},
+  {"r4", bulk_kernel<double2, recip_double2_r4>},
+  {"r5", bulk_kernel<double2, recip_double2_r5>},
+  {"magic_r5", bulk_kernel<double2, recip_double2_magic_r5>},
+  {"minimax3", MINIMAX_KERNEL(recip, Recip, double2, 3)},
+  {"minimax4", MINIMAX_KERNEL(recip, Recip, double2, 4)},
+  {"minimax5", MINIMAX_KERNEL(recip, Recip, double2, 5)},
+  {"ieee", bulk_kernel<double2, recip_double2_ieee>},
+  {0, 0}
+};
+static const NamedKernel<float> rsqrt_float_candidates[] = {
+  {"fast", bulk_kernel<float4, rsqrt_float4_fast>},
+  {"nr1", bulk_kernel<float4, rsqrt_float4_nr1>},
+  {"minimax2", MINIMAX_KERNEL(rsqrt, Rsqrt, float4, 2)},
+  {"ieee", bulk_kernel<float4, rsqrt_float4_ieee>},
+  {0, 0}
+};
+static const NamedKernel<double> rsqrt_double_candidates[] = {
+  {"fast", bulk_kernel<double2, rsqrt_double2_fast>},
+  {"nr1", bulk_kernel<double2, rsqrt_double2_nr1>},
+  {"nr2", bulk_kernel<double2, rsqrt_double2_nr2>},
+  {"r2", bulk_kernel<double2, rsqrt_double2_r2>},
+  {"r3", bulk_kernel<double2, rsqrt_double2_r3>},
+  {"r4", bulk_kernel<double2, rsqrt_double2_r4>},
+  {"r5", bulk_kernel<double2, rsqrt_double2_r5>},
+  {"magic_r5", bulk_kernel<double2, rsqrt_double2_magic_r5>},
+  {"minimax3", MINIMAX_KERNEL(rsqrt, Rsqrt, double2, 3)},
+  {"minimax4", MINIMAX_KERNEL(rsqrt, Rsqrt, double2, 4)},
+  {"minimax5", MINIMAX_KERNEL(rsqrt, Rsqrt, double2, 5)},
+  {"ieee", bulk_kernel<double2, rsqrt_double2_ieee>},
+  {0, 0}
+};
+
+extern const RecipRsqrtKernels recip_rsqrt_kernels_sse2 = {
+  "sse2",
+  //Fast, Medium, High, Exact
+  {
+    bulk_kernel<float4, recip_float4_fast>,
+    bulk_kernel<float4, recip_float4_nr1>,
+    bulk_kernel<float4, recip_float4_nr1>,
+    bulk_kernel<float4, recip_float4_ieee>,
+  }, {
+    bulk_kernel<double2, recip_double2_fast>,
+    bulk_kernel<double2, recip_double2_nr1>,
+    bulk_kernel<double2, recip_double2_r5>,
+    bulk_kernel<double2, recip_double2_ieee>,
+  }, {
+    bulk_kernel<float4, rsqrt_float4_fast>,
+    bulk_kernel<float4, rsqrt_float4_nr1>,
+    bulk_kernel<float4, rsqrt_float4_nr1>,
+    bulk_kernel<float4, rsqrt_float4_ieee>,
+  }, {
+    bulk_kernel<double2, rsqrt_double2_fast>,
+    bulk_kernel<double2, rsqrt_double2_nr1>,
+    bulk_kernel<double2, rsqrt_double2_r5>,
+    bulk_kernel<double2, rsqrt_double2_ieee>,
+  },
+  recip_float_candidates, recip_double_candidates,
+  rsqrt_float_candidates, rsqrt_double_candidates,
+  NORMALIZE_TIERS(normalize_soa, float4, 3),
+  NORMALIZE_TIERS(normalize_soa, float4, 4),
+  NORMALIZE_TIERS(normalize_aos, float4, 3),
+  NORMALIZE_TIERS(normalize_aos, float4, 4),
+  {
+    bulk_kernel2<float4, div_float4_fast>,
+    bulk_kernel2<float4, div_float4_nr1>,
+    bulk_kernel2<float4, div_float4_nr1>,
+    bulk_kernel2<float4, div_float4_ieee>,
+  }, {
+    bulk_kernel2<double2, div_double2_fast>,
+    bulk_kernel2<double2, div_double2_nr1>,
+    bulk_kernel2<double2, div_double2_r3>,
+    bulk_kernel2<double2, div_double2_ieee>,
+  }, {
+    bulk_kernel<float4, sqrt_float4_fast>,
+    bulk_kernel<float4, sqrt_float4_nr1>,
+    bulk_kernel<float4, sqrt_float4_nr1>,
+    bulk_kernel<float4, sqrt_float4_ieee>,
+  }, {
+    bulk_kernel<double2, sqrt_double2_fast>,
+    bulk_kernel<double2, sqrt_double2_nr1>,
+    bulk_kernel<double2, sqrt_double2_r3>,
+    bulk_kernel<double2, sqrt_double2_ieee>,
+  },
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+//High-precision reference for recip, rsqrt, sqrt, division and inverse cube / fourth roots, and error measurement in ULPs.
+//Reference is returned as unevaluated sum hi + lo of two doubles (double-double),
+//its relative error is about 2^-104, so it can judge even correctly rounded double results.
+//Only positive finite inputs are supported.
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+struct dd {
+  double hi, lo;
+};
+
+//a + b = s + e exactly, requires |a| >= |b|
+static inline dd fast_two_sum(double a, double b) {
+  double s = a + b;
+  dd res = {s, b - (s - a)};
+  return res;
+}
+
+//a * b = p + e exactly
+static inline dd two_prod(double a, double b) {
+  double p = a * b;
+#ifdef __FMA__
+  dd res = {p, std::fma(a, b, -p)};
+#else
+  //Dekker's algorithm: safe because compiler cannot contract into FMA without FMA support
+  const double splitter = 134217729.0;    //2^27 + 1
+  double ta = splitter * a, tb = splitter * b;
+  double ah = ta - (ta - a), al = a - ah;
+  double bh = tb - (tb - b), bl = b - bh;
+  dd res = {p, ((ah * bh - p) + ah * bl + al * bh) + al * bl};
+#endif
+  return res;
+}
+
+static inline dd dd_ldexp(dd x, int e) {
+  dd res = {std::ldexp(x.hi, e), std::ldexp(x.lo, e)};
+  return res;
+}
+
+static inline dd reference_recip(double x) {
+  //x = m * 2^e, with m in [0.5, 1)
+  int e;
+  double m = std::frexp(x, &e);
+  double y = 1.0 / m;
+  //residual r = 1 - m y is computed exactly, then 1/m = y (1 + r + r^2 + ...)
+  dd p = two_prod(m, y);
+  double r = (1.0 - p.hi) - p.lo;
+  return dd_ldexp(fast_two_sum(y, y * r), -e);
+}
+
+static inline dd reference_rsqrt(double x) {
+  //x = m * 2^e, with even e and m in [0.5, 2)
+  int e;
+  double m = std::frexp(x, &e);
+  if (e % 2 != 0) {
+    m *= 2.0;
+    e -= 1;
+  }
+  double y = 1.0 / std::sqrt(m);
+  //residual r = 1 - m y^2 is computed exactly, then 1/sqrt(m) = y (1 + 1/2 r + 3/8 r^2 + ...)
+  dd y2 = two_prod(y, y);
+  dd p = two_prod(m, y2.hi);
+  double r = ((1.0 - p.hi) - p.lo) - m * y2.lo;
+  return dd_ldexp(fast_two_sum(y, y * (0.5 * r + 0.375 * r * r)), -e / 2);
+}
+
+static inline dd reference_sqrt(double x) {
+  //x = m * 2^e, with even e and m in [0.5, 2)
+  int e;
+  double m = std::frexp(x, &e);
+  if (e % 2 != 0) {
+    m *= 2.0;
+    e -= 1;
+  }
+  double y = std::sqrt(m);
+  //residual r = m - y^2 is computed exactly, then sqrt(m) = y + r / (2y) + O(r^2)
+  dd p = two_prod(y, y);
+  double r = (m - p.hi) - p.lo;
+  return dd_ldexp(fast_two_sum(y, r / (2.0 * y)), e / 2);
+}
+
+static inline dd reference_div(double a, double b) {
+  //a = ma * 2^ea, b = mb * 2^eb, with ma, mb in [0.5, 1)
+  int ea, eb;
+  double ma = std::frexp(a, &ea), mb = std::frexp(b, &eb);
+  double q = ma / mb;
+  //residual r = ma - mb q is computed exactly, then ma / mb = q + r / mb
+  dd p = two_prod(q, mb);
+  double r = (ma - p.hi) - p.lo;
+  return dd_ldexp(fast_two_sum(q, r / mb), ea - eb);
+}
+
+//x = m * 2^e with e divisible by n and m in [0.5, 2^(n-1))
+static inline double frexp_multiple(double x, int n, int *e) {
+  double m = std::frexp(x, e);
+  int k = ((*e % n) + n) % n;
+  *e -= k;
+  return std::ldexp(m, k);
+}
+
+static inline dd reference_rcbrt(double x) {
+  int e;
+  double m = frexp_multiple(x, 3, &e);
+  double y = 1.0 / std::cbrt(m);
+  //residual r = 1 - m y^3 with error about 2^-106, then m^(-1/3) = y (1 + 1/3 r + 2/9 r^2 + ...)
+  dd y2 = two_prod(y, y);
+  dd y3 = two_prod(y2.hi, y);
+  dd p = two_prod(m, y3.hi);
+  double r = ((1.0 - p.hi) - p.lo) - m * (y3.lo + y2.lo * y);
+  return dd_ldexp(fast_two_sum(y, y * (r / 3.0 + (2.0 / 9.0) * r * r)), -e / 3);
+}
+
+static inline dd reference_rqrt(double x) {
+  int e;
+  double m = frexp_multiple(x, 4, &e);
+  double y = 1.0 / std::sqrt(std::sqrt(m));
+  //residual r = 1 - m y^4 with error about 2^-106, then m^(-1/4) = y (1 + 1/4 r + 5/32 r^2 + ...)
+  dd y2 = two_prod(y, y);
+  dd y4 = two_prod(y2.hi, y2.hi);
+  dd p = two_prod(m, y4.hi);
+  double r = ((1.0 - p.hi) - p.lo) - m * (y4.lo + 2.0 * y2.hi * y2.lo);
+  return dd_ldexp(fast_two_sum(y, y * (0.25 * r + 0.15625 * r * r)), -e / 4);
+}
+
+//x^(-2/3) as square of double-double x^(-1/3)
+static inline dd reference_rcbrt2(double x) {
+  dd y = reference_rcbrt(x);
+  dd s = two_prod(y.hi, y.hi);
+  return fast_two_sum(s.hi, s.lo + 2.0 * y.hi * y.lo);
+}
+
+//unit in the last place of type T at the magnitude of value
+template<class T> static inline double ulp_of(double value) {
+  int e;
+  std::frexp(value, &e);
+  //value in [2^(e-1), 2^e): ulp is 2^(e - digits), but not less than the smallest subnormal
+  int minExp = std::numeric_limits<T>::min_exponent;
+  return std::ldexp(1.0, std::max(e, minExp) - std::numeric_limits<T>::digits);
+}
+
+//error of result (of type T) in ULPs of T, infinite if result is NaN
+template<class T> static inline double ulp_error(T result, dd reference) {
+  double diff = (double(result) - reference.hi) - reference.lo;
+  if (std::isnan(diff))
+    return std::numeric_limits<double>::infinity();
+  return std::fabs(diff) / ulp_of<T>(reference.hi);
+}
+
+//relative error of result, infinite if result is NaN
+template<class T> static inline double relative_error(T result, dd reference) {
+  double diff = (double(result) - reference.hi) - reference.lo;
+  if (std::isnan(diff))
+    return std::numeric_limits<double>::infinity();
+  return std::fabs(diff / reference.hi);
+}
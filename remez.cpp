@@ -0,0 +1,200 @@
+//Offline fitter of minimax coefficients for relative correctors (see corrector.h).
+//Usage: g++ -O2 remez.cpp -o remez && ./remez > minimax_coefs.h
+//
+//Corrector computes x := x P(r), where r is residual of seed (1 - a x or 1 - a x^2),
+//so P(r) should approximate g(r) = 1/(1-r) for recip, or 1/sqrt(1-r) for rsqrt.
+//Taylor polynomial T(r) = a_0 + a_1 r + ... + a_m r^m is exact at r = 0 only;
+//here P(r) = T(r) + delta(r) minimizes max relative error |P/g - 1| over the whole interval |r| <= eps,
+//which is known from the documented error bound of rcpps / rsqrtps.
+//Remez exchange algorithm is used. Unknowns are small deviations delta_k from Taylor coefficients,
+//and error of T is computed from its series tail, so that long double is precise enough for all orders.
+
+#include <stdio.h>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+typedef long double real;
+
+//a_k of series g(r) = sum a_k r^k
+static real series_coef(bool rsqrt, int k) {
+  real res = 1;
+  if (rsqrt)
+    for (int i = 1; i <= k; i++)
+      res = res * (2 * i - 1) / (2 * i);
+  return res;
+}
+
+static real func_g(bool rsqrt, real r) {
+  return rsqrt ? 1 / sqrtl(1 - r) : 1 / (1 - r);
+}
+
+//g(r) - T(r) = sum of a_k r^k over k > m
+static real series_tail(bool rsqrt, int m, real r) {
+  real sum = 0, term = 1;
+  for (int k = 1; k <= m; k++)
+    term *= r;
+  for (int k = m + 1; k < m + 40; k++) {
+    term *= r;
+    sum += series_coef(rsqrt, k) * term;
+  }
+  return sum;
+}
+
+//relative error of P = T + delta at r = eps t, where beta_k = delta_k eps^k
+static real rel_error(bool rsqrt, int m, real eps, const vector<real> &beta, real t) {
+  real d = 0;
+  for (int k = m; k >= 0; k--)
+    d = d * t + beta[k];
+  return (d - series_tail(rsqrt, m, eps * t)) / func_g(rsqrt, eps * t);
+}
+
+//solves A x = b by Gaussian elimination with partial pivoting (A is n x n, row-major)
+static vector<real> solve(vector<real> A, vector<real> b) {
+  int n = int(b.size());
+  for (int c = 0; c < n; c++) {
+    int p = c;
+    for (int i = c + 1; i < n; i++)
+      if (fabsl(A[i * n + c]) > fabsl(A[p * n + c]))
+        p = i;
+    for (int j = 0; j < n; j++)
+      swap(A[c * n + j], A[p * n + j]);
+    swap(b[c], b[p]);
+    for (int i = c + 1; i < n; i++) {
+      real f = A[i * n + c] / A[c * n + c];
+      for (int j = c; j < n; j++)
+        A[i * n + j] -= f * A[c * n + j];
+      b[i] -= f * b[c];
+    }
+  }
+  vector<real> x(n);
+  for (int i = n - 1; i >= 0; i--) {
+    real s = b[i];
+    for (int j = i + 1; j < n; j++)
+      s -= A[i * n + j] * x[j];
+    x[i] = s / A[i * n + i];
+  }
+  return x;
+}
+
+//fits polynomial of degree m (corrector of order m + 1), returns its coefficients and max relative error
+static vector<real> fit(bool rsqrt, int m, real eps, real &maxError) {
+  int n = m + 2;
+  vector<real> pts(n), beta(m + 1, 0);
+  for (int i = 0; i < n; i++)
+    pts[i] = -cosl(3.14159265358979323846L * i / (n - 1));
+
+  for (int iter = 0; iter < 100; iter++) {
+    //equations: delta(r_i) - (-1)^i E g(r_i) = tail(r_i)
+    vector<real> A(n * n), b(n);
+    for (int i = 0; i < n; i++) {
+      real tp = 1;
+      for (int k = 0; k <= m; k++, tp *= pts[i])
+        A[i * n + k] = tp;
+      A[i * n + m + 1] = (i % 2 ? 1 : -1) * func_g(rsqrt, eps * pts[i]);
+      b[i] = series_tail(rsqrt, m, eps * pts[i]);
+    }
+    vector<real> sol = solve(A, b);
+    beta.assign(sol.begin(), sol.begin() + m + 1);
+
+    //find alternating extrema of error on dense grid, then refine each by ternary search
+    const int grid = 4000;
+    vector<real> ext, extErr;
+    for (int j = 0; j <= grid; j++) {
+      real t = -1 + 2 * real(j) / grid;
+      real e = rel_error(rsqrt, m, eps, beta, t);
+      if (!ext.empty() && (e > 0) == (extErr.back() > 0)) {
+        if (fabsl(e) > fabsl(extErr.back())) {
+          ext.back() = t;
+          extErr.back() = e;
+        }
+      }
+      else {
+        ext.push_back(t);
+        extErr.push_back(e);
+      }
+    }
+    for (size_t i = 0; i < ext.size(); i++) {
+      real lo = max(real(-1), ext[i] - real(2) / grid), hi = min(real(1), ext[i] + real(2) / grid);
+      real sign = (extErr[i] > 0 ? 1 : -1);
+      for (int it = 0; it < 100; it++) {
+        real m1 = lo + (hi - lo) / 3, m2 = hi - (hi - lo) / 3;
+        if (sign * rel_error(rsqrt, m, eps, beta, m1) < sign * rel_error(rsqrt, m, eps, beta, m2))
+          lo = m1;
+        else
+          hi = m2;
+      }
+      real t = (lo + hi) / 2, e = rel_error(rsqrt, m, eps, beta, t);
+      if (sign * e > sign * extErr[i]) {
+        ext[i] = t;
+        extErr[i] = e;
+      }
+    }
+    //drop the smallest extrema from the ends
+    while (int(ext.size()) > n) {
+      if (fabsl(extErr.front()) < fabsl(extErr.back())) {
+        ext.erase(ext.begin());
+        extErr.erase(extErr.begin());
+      }
+      else {
+        ext.pop_back();
+        extErr.pop_back();
+      }
+    }
+    if (int(ext.size()) < n)
+      break;
+
+    real lo = fabsl(extErr[0]), hi = lo;
+    for (int i = 1; i < n; i++) {
+      lo = min(lo, fabsl(extErr[i]));
+      hi = max(hi, fabsl(extErr[i]));
+    }
+    pts = ext;
+    maxError = hi;
+    if (hi - lo < hi * 1e-6L)
+      break;
+  }
+
+  //delta_k = beta_k / eps^k, coefficients are a_k + delta_k, but the constant term is stored as delta_0 = P(0) - 1
+  vector<real> coefs(m + 1);
+  real ep = 1;
+  for (int k = 0; k <= m; k++, ep *= eps)
+    coefs[k] = (k == 0 ? 0 : series_coef(rsqrt, k)) + beta[k] / ep;
+  return coefs;
+}
+
+int main() {
+  const int minOrder = 2, maxOrder = 6;
+  //rcpps / rsqrtps have relative error at most 1.5 * 2^-12; for double kernels, input is rounded to float first
+  real seedErr = 1.5L / 4096, roundErr = 1.0L / (1 << 24);
+  real epsRecip = (1 + seedErr) * (1 + roundErr) - 1;
+  real epsRsqrt = (1 + seedErr) * (1 + seedErr) * (1 + roundErr) - 1;
+
+  printf("#pragma once\n\n");
+  printf("//generated by remez.cpp, do not edit\n");
+  printf("//minimax_<func>_coefs[N] are coefficients of corrector of order N: x := x + x D(r),\n");
+  printf("//where D(r) = P(r) - 1 = d_0 + d_1 r + ... + d_{N-1} r^{N-1} and P minimizes relative error\n");
+  printf("//to 1/(1-r) (recip) or 1/sqrt(1-r) (rsqrt) over |r| <= eps; rows for orders below %d are unused\n", minOrder);
+  for (int f = 0; f < 2; f++) {
+    bool rsqrt = (f == 1);
+    const char *name = rsqrt ? "rsqrt" : "recip";
+    real eps = rsqrt ? epsRsqrt : epsRecip;
+    printf("\n//%s: eps = %0.6Le\n", name, eps);
+    printf("constexpr double minimax_%s_coefs[%d][%d] = {\n", name, maxOrder + 1, maxOrder);
+    for (int order = 0; order <= maxOrder; order++) {
+      printf("  {");
+      if (order >= minOrder) {
+        real maxError = 0;
+        vector<real> coefs = fit(rsqrt, order - 1, eps, maxError);
+        for (int k = 0; k < order; k++)
+          printf("%s%0.20Le", k ? ", " : "", coefs[k]);
+        printf("},    //max relative error %0.3Le\n", maxError);
+      }
+      else
+        printf("0},\n");
+    }
+    printf("};\n");
+  }
+  return 0;
+}
@@ -0,0 +1,366 @@
+//requires AVX2 and FMA (e.g. -mavx2 -mfma or /arch:AVX2)
+
+#include <cfloat>
+#include "safe_ranges.h"
+
+//=================== float =================
+
+//canonical
+static FORCEINLINE __m256 recip_float8_ieee(__m256 x) {
+  return _mm256_div_ps(_mm256_set1_ps(1.0f), x);
+}
+static FORCEINLINE __m256 rsqrt_float8_ieee(__m256 x) {
+  return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(x));
+}
+//fast approximation
+static FORCEINLINE __m256 recip_float8_fast(__m256 x) {
+  return _mm256_rcp_ps(x);
+}
+static FORCEINLINE __m256 rsqrt_float8_fast(__m256 x) {
+  return _mm256_rsqrt_ps(x);
+}
+//with Newton-Raphson (residual is computed with FMA)
+static FORCEINLINE __m256 recip_float8_nr1(__m256 x) {
+  __m256 res, r;
+  res = _mm256_rcp_ps(x);
+  r = _mm256_fnmadd_ps(x, res, _mm256_set1_ps(1.0f));   // 1 - x * res
+  res = _mm256_fmadd_ps(res, r, res);
+  return res;
+}
+static FORCEINLINE __m256 rsqrt_float8_nr1(__m256 x) {
+  __m256 three = _mm256_set1_ps(3.0f), half = _mm256_set1_ps(0.5f);
+  __m256 res, muls;
+  res = _mm256_rsqrt_ps(x);
+  muls = _mm256_fnmadd_ps(_mm256_mul_ps(x, res), res, three);   // 3 - x * res^2
+  res = _mm256_mul_ps(_mm256_mul_ps(half, res), muls);
+  return res;
+}
+
+//=================== double =================
+
+//canonical
+static FORCEINLINE __m256d recip_double4_ieee(__m256d x) {
+  return _mm256_div_pd(_mm256_set1_pd(1.0), x);
+}
+static FORCEINLINE __m256d rsqrt_double4_ieee(__m256d x) {
+  return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(x));
+}
+//fast approximation (with conversion)
+static FORCEINLINE __m256d recip_double4_fast(__m256d x) {
+  __m128 f = _mm256_cvtpd_ps(x);
+  f = _mm_rcp_ps(f);
+  return _mm256_cvtps_pd(f);
+}
+static FORCEINLINE __m256d rsqrt_double4_fast(__m256d x) {
+  __m128 f = _mm256_cvtpd_ps(x);
+  f = _mm_rsqrt_ps(f);
+  return _mm256_cvtps_pd(f);
+}
+//with Newton-Raphson (residual is computed with FMA)
+static FORCEINLINE __m256d recip_double4_nr1(__m256d x) {
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d res, r;
+  res = _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(x)));
+  r = _mm256_fnmadd_pd(x, res, one);
+  res = _mm256_fmadd_pd(res, r, res);
+  return res;
+}
+static FORCEINLINE __m256d rsqrt_double4_nr1(__m256d x) {
+  __m256d three = _mm256_set1_pd(3.0), half = _mm256_set1_pd(0.5);
+  __m256d res, muls;
+  res = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(x)));
+  muls = _mm256_fnmadd_pd(_mm256_mul_pd(x, res), res, three);
+  res = _mm256_mul_pd(_mm256_mul_pd(half, res), muls);
+  return res;
+}
+static FORCEINLINE __m256d recip_double4_nr2(__m256d x) {
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d res, r;
+  res = _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(x)));
+  r = _mm256_fnmadd_pd(x, res, one);
+  res = _mm256_fmadd_pd(res, r, res);
+  r = _mm256_fnmadd_pd(x, res, one);
+  res = _mm256_fmadd_pd(res, r, res);
+  return res;
+}
+static FORCEINLINE __m256d rsqrt_double4_nr2(__m256d x) {
+  __m256d three = _mm256_set1_pd(3.0), half = _mm256_set1_pd(0.5);
+  __m256d res, muls;
+  res = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(x)));
+  muls = _mm256_fnmadd_pd(_mm256_mul_pd(x, res), res, three);
+  res = _mm256_mul_pd(_mm256_mul_pd(half, res), muls);
+  muls = _mm256_fnmadd_pd(_mm256_mul_pd(x, res), res, three);
+  res = _mm256_mul_pd(_mm256_mul_pd(half, res), muls);
+  return res;
+}
+
+//relative correctors: same polynomials as in routines_sse.h,
+//but residual r and all multiply-adds are fused
+
+static FORCEINLINE __m256d recip_double4_r5(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d x = _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(a)));
+  __m256d r = _mm256_fnmadd_pd(a, x, one);
+  __m256d r2r = _mm256_fmadd_pd(r, r, r);     // r^2 + r
+  __m256d r21 = _mm256_fmadd_pd(r, r, one);   // r^2 + 1
+  __m256d poly = _mm256_mul_pd(r2r, r21);
+  __m256d res = _mm256_fmadd_pd(poly, x, x);
+  return res;
+}
+
+static FORCEINLINE __m256d recip_double4_r4(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d x = _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(a)));
+  __m256d r = _mm256_fnmadd_pd(a, x, one);
+  __m256d r1 = _mm256_add_pd(r, one);         // r + 1
+  __m256d r21 = _mm256_fmadd_pd(r, r, one);   // r^2 + 1
+  __m256d poly = _mm256_mul_pd(r1, r21);
+  __m256d res = _mm256_mul_pd(poly, x);
+  return res;
+}
+
+static FORCEINLINE __m256d recip_double4_r3(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d x = _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(a)));
+  __m256d r = _mm256_fnmadd_pd(a, x, one);
+  __m256d poly = _mm256_fmadd_pd(r, r, r);    // r^2 + r
+  __m256d res = _mm256_fmadd_pd(poly, x, x);
+  return res;
+}
+
+static FORCEINLINE __m256d rsqrt_double4_r2(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0), c1_2 = _mm256_set1_pd(1.0/2.0);
+  __m256d x = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a)));
+  __m256d r = _mm256_fnmadd_pd(_mm256_mul_pd(a, x), x, one);
+  __m256d res = _mm256_fmadd_pd(_mm256_mul_pd(c1_2, x), r, x);
+  return res;
+}
+
+static FORCEINLINE __m256d rsqrt_double4_r3(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0), c1 = _mm256_set1_pd(1.0/2.0), c2 = _mm256_set1_pd(3.0/8.0);
+  __m256d x = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a)));
+  __m256d r = _mm256_fnmadd_pd(_mm256_mul_pd(a, x), x, one);
+  __m256d t1 = _mm256_fmadd_pd(c2, r, c1);
+  __m256d res = _mm256_fmadd_pd(_mm256_mul_pd(r, x), t1, x);
+  return res;
+}
+
+static FORCEINLINE __m256d rsqrt_double4_r4(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0), c1 = _mm256_set1_pd(1.0/2.0), c2 = _mm256_set1_pd(3.0/8.0), c3 = _mm256_set1_pd(15.0/48.0);
+  __m256d x = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a)));
+  __m256d r = _mm256_fnmadd_pd(_mm256_mul_pd(a, x), x, one);
+  __m256d r2 = _mm256_mul_pd(r, r);
+  __m256d t1 = _mm256_fmadd_pd(c2, r, c1);
+  __m256d poly = _mm256_fmadd_pd(r2, c3, t1);
+  __m256d res = _mm256_fmadd_pd(_mm256_mul_pd(x, r), poly, x);
+  return res;
+}
+
+static FORCEINLINE __m256d rsqrt_double4_r5(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0), c1 = _mm256_set1_pd(1.0/2.0), c2 = _mm256_set1_pd(3.0/8.0), c3 = _mm256_set1_pd(15.0/48.0), c4 = _mm256_set1_pd(105.0/384.0);
+  __m256d x = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a)));
+  __m256d r = _mm256_fnmadd_pd(_mm256_mul_pd(a, x), x, one);
+  __m256d r2 = _mm256_mul_pd(r, r);
+  __m256d t1 = _mm256_fmadd_pd(c2, r, c1);
+  __m256d t3 = _mm256_fmadd_pd(c4, r, c3);
+  __m256d poly = _mm256_fmadd_pd(r2, t3, t1);
+  __m256d res = _mm256_fmadd_pd(_mm256_mul_pd(x, r), poly, x);
+  return res;
+}
+
+//full-range seeds from magic constant (see routines_sse.h)
+
+static FORCEINLINE __m256d recip_double4_magic(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256i magic = _mm256_set1_epi64x(0x7FDE623850373513LL);
+  __m256d x = _mm256_castsi256_pd(_mm256_sub_epi64(magic, _mm256_castpd_si256(a)));
+  __m256d r = _mm256_fnmadd_pd(a, x, one);
+  __m256d poly = _mm256_fmadd_pd(r, r, r);    // r^2 + r
+  __m256d res = _mm256_fmadd_pd(poly, x, x);
+  return res;
+}
+
+static FORCEINLINE __m256d recip_double4_magic_r5(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d x = recip_double4_magic(a);
+  __m256d r = _mm256_fnmadd_pd(a, x, one);
+  __m256d r2r = _mm256_fmadd_pd(r, r, r);     // r^2 + r
+  __m256d r21 = _mm256_fmadd_pd(r, r, one);   // r^2 + 1
+  __m256d poly = _mm256_mul_pd(r2r, r21);
+  __m256d res = _mm256_fmadd_pd(poly, x, x);
+  return res;
+}
+
+static FORCEINLINE __m256d rsqrt_double4_magic(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0), c1 = _mm256_set1_pd(1.0/2.0), c2 = _mm256_set1_pd(3.0/8.0);
+  __m256i magic = _mm256_set1_epi64x(0x5FE6E71B1E8B76CFLL);
+  __m256d x = _mm256_castsi256_pd(_mm256_sub_epi64(magic, _mm256_srli_epi64(_mm256_castpd_si256(a), 1)));
+  __m256d r = _mm256_fnmadd_pd(_mm256_mul_pd(a, x), x, one);
+  __m256d t1 = _mm256_fmadd_pd(c2, r, c1);
+  __m256d res = _mm256_fmadd_pd(_mm256_mul_pd(r, x), t1, x);
+  return res;
+}
+
+static FORCEINLINE __m256d rsqrt_double4_magic_r5(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0), c1 = _mm256_set1_pd(1.0/2.0), c2 = _mm256_set1_pd(3.0/8.0), c3 = _mm256_set1_pd(15.0/48.0), c4 = _mm256_set1_pd(105.0/384.0);
+  __m256d x = rsqrt_double4_magic(a);
+  __m256d r = _mm256_fnmadd_pd(_mm256_mul_pd(a, x), x, one);
+  __m256d r2 = _mm256_mul_pd(r, r);
+  __m256d t1 = _mm256_fmadd_pd(c2, r, c1);
+  __m256d t3 = _mm256_fmadd_pd(c4, r, c3);
+  __m256d poly = _mm256_fmadd_pd(r2, t3, t1);
+  __m256d res = _mm256_fmadd_pd(_mm256_mul_pd(x, r), poly, x);
+  return res;
+}
+
+//=================== division and square root =================
+
+//numerator is folded into the last correction (see routines_sse.h), residuals are computed with FMA
+
+//canonical
+static FORCEINLINE __m256 div_float8_ieee(__m256 a, __m256 b) {
+  return _mm256_div_ps(a, b);
+}
+static FORCEINLINE __m256 sqrt_float8_ieee(__m256 x) {
+  return _mm256_sqrt_ps(x);
+}
+//fast approximation
+static FORCEINLINE __m256 div_float8_fast(__m256 a, __m256 b) {
+  return _mm256_mul_ps(a, _mm256_rcp_ps(b));
+}
+static FORCEINLINE __m256 sqrt_float8_fast(__m256 x) {
+  return _mm256_mul_ps(x, _mm256_rsqrt_ps(_mm256_max_ps(x, _mm256_set1_ps(FLT_MIN))));
+}
+//with one correction
+static FORCEINLINE __m256 div_float8_nr1(__m256 a, __m256 b) {
+  __m256 y = _mm256_rcp_ps(b);
+  __m256 q = _mm256_mul_ps(a, y);
+  __m256 r = _mm256_fnmadd_ps(b, q, a);
+  return _mm256_fmadd_ps(r, y, q);
+}
+static FORCEINLINE __m256 sqrt_float8_nr1(__m256 x) {
+  __m256 y = _mm256_rsqrt_ps(_mm256_max_ps(x, _mm256_set1_ps(FLT_MIN)));
+  __m256 s = _mm256_mul_ps(x, y), h = _mm256_mul_ps(y, _mm256_set1_ps(0.5f));
+  __m256 d = _mm256_fnmadd_ps(s, s, x);
+  return _mm256_fmadd_ps(d, h, s);
+}
+
+//canonical
+static FORCEINLINE __m256d div_double4_ieee(__m256d a, __m256d b) {
+  return _mm256_div_pd(a, b);
+}
+static FORCEINLINE __m256d sqrt_double4_ieee(__m256d x) {
+  return _mm256_sqrt_pd(x);
+}
+//fast approximation (with conversion)
+static FORCEINLINE __m256d div_double4_fast(__m256d a, __m256d b) {
+  return _mm256_mul_pd(a, recip_double4_fast(b));
+}
+static FORCEINLINE __m256d sqrt_double4_fast(__m256d x) {
+  return _mm256_mul_pd(x, rsqrt_double4_fast(_mm256_max_pd(x, _mm256_set1_pd(FLT_MIN))));
+}
+//correction applied to y from given recip / rsqrt kernel
+static FORCEINLINE __m256d div_double4_correct(__m256d a, __m256d b, __m256d y) {
+  __m256d q = _mm256_mul_pd(a, y);
+  __m256d r = _mm256_fnmadd_pd(b, q, a);
+  return _mm256_fmadd_pd(r, y, q);
+}
+static FORCEINLINE __m256d sqrt_double4_correct(__m256d x, __m256d y) {
+  __m256d s = _mm256_mul_pd(x, y), h = _mm256_mul_pd(y, _mm256_set1_pd(0.5));
+  __m256d d = _mm256_fnmadd_pd(s, s, x);
+  return _mm256_fmadd_pd(d, h, s);
+}
+//y from seed: about single precision
+static FORCEINLINE __m256d div_double4_nr1(__m256d a, __m256d b) {
+  return div_double4_correct(a, b, recip_double4_fast(b));
+}
+static FORCEINLINE __m256d sqrt_double4_nr1(__m256d x) {
+  return sqrt_double4_correct(x, rsqrt_double4_fast(_mm256_max_pd(x, _mm256_set1_pd(FLT_MIN))));
+}
+//y from cubic corrector (e ~ 2^-34): error of result is dominated by rounding
+static FORCEINLINE __m256d div_double4_r3(__m256d a, __m256d b) {
+  return div_double4_correct(a, b, recip_double4_r3(b));
+}
+static FORCEINLINE __m256d sqrt_double4_r3(__m256d x) {
+  return sqrt_double4_correct(x, rsqrt_double4_r3(_mm256_max_pd(x, _mm256_set1_pd(FLT_MIN))));
+}
+
+//=================== special values =================
+
+//safe variants of any kernel (see routines_sse.h)
+
+static FORCEINLINE bool all_in_range_float8(__m256 x, float high) {
+  __m256 ok = _mm256_and_ps(_mm256_cmp_ps(x, _mm256_set1_ps(1.0f / high), _CMP_GE_OQ), _mm256_cmp_ps(x, _mm256_set1_ps(high), _CMP_LE_OQ));
+  return _mm256_movemask_ps(ok) == 0xFF;
+}
+static FORCEINLINE __m256 reduce_float8(__m256 x, __m256 &scale) {
+  __m256i e = _mm256_srli_epi32(_mm256_slli_epi32(_mm256_castps_si256(x), 1), 24);
+  __m256i h = _mm256_srli_epi32(_mm256_add_epi32(e, _mm256_set1_epi32(1)), 1);
+  scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_sub_epi32(_mm256_set1_epi32(127 + 64), h), 23));
+  return _mm256_mul_ps(_mm256_mul_ps(x, scale), scale);
+}
+static FORCEINLINE __m256 fixup_float8(__m256 x, __m256 res, __m256 zero, __m256 special) {
+  __m256 inf = _mm256_castsi256_ps(_mm256_set1_epi32(0x7F800000));
+  __m256 fix = _mm256_or_ps(_mm256_and_ps(zero, inf), _mm256_and_ps(x, _mm256_set1_ps(-0.0f)));
+  return _mm256_blendv_ps(res, fix, special);
+}
+template<__m256 (*Kernel)(__m256)> static FORCEINLINE __m256 recip_float8_safe(__m256 x) {
+  if (all_in_range_float8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), x), recip_direct_max))
+    return Kernel(x);
+  __m256 inf = _mm256_castsi256_ps(_mm256_set1_epi32(0x7F800000));
+  __m256 scale;
+  __m256 res = Kernel(reduce_float8(x, scale));
+  res = _mm256_mul_ps(_mm256_mul_ps(res, scale), scale);
+  __m256 zero = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_EQ_OQ);
+  __m256 special = _mm256_or_ps(zero, _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), x), inf, _CMP_EQ_OQ));
+  return fixup_float8(x, res, zero, special);
+}
+template<__m256 (*Kernel)(__m256)> static FORCEINLINE __m256 rsqrt_float8_safe(__m256 x) {
+  if (all_in_range_float8(x, rsqrt_direct_max))
+    return Kernel(x);
+  __m256 inf = _mm256_castsi256_ps(_mm256_set1_epi32(0x7F800000));
+  __m256 scale;
+  __m256 res = Kernel(reduce_float8(x, scale));
+  res = _mm256_mul_ps(res, scale);
+  __m256 zero = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_EQ_OQ);
+  __m256 special = _mm256_or_ps(zero, _mm256_cmp_ps(x, inf, _CMP_EQ_OQ));
+  return fixup_float8(x, res, zero, special);
+}
+
+static FORCEINLINE bool all_in_range_double4(__m256d x, double high) {
+  __m256d ok = _mm256_and_pd(_mm256_cmp_pd(x, _mm256_set1_pd(1.0 / high), _CMP_GE_OQ), _mm256_cmp_pd(x, _mm256_set1_pd(high), _CMP_LE_OQ));
+  return _mm256_movemask_pd(ok) == 0xF;
+}
+static FORCEINLINE __m256d reduce_double4(__m256d x, __m256d &scale) {
+  __m256i e = _mm256_srli_epi64(_mm256_slli_epi64(_mm256_castpd_si256(x), 1), 53);
+  __m256i h = _mm256_srli_epi64(_mm256_add_epi64(e, _mm256_set1_epi64x(1)), 1);
+  scale = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_sub_epi64(_mm256_set1_epi64x(1023 + 512), h), 52));
+  return _mm256_mul_pd(_mm256_mul_pd(x, scale), scale);
+}
+static FORCEINLINE __m256d fixup_double4(__m256d x, __m256d res, __m256d zero, __m256d special) {
+  __m256d inf = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FF0000000000000LL));
+  __m256d fix = _mm256_or_pd(_mm256_and_pd(zero, inf), _mm256_and_pd(x, _mm256_set1_pd(-0.0)));
+  return _mm256_blendv_pd(res, fix, special);
+}
+template<__m256d (*Kernel)(__m256d)> static FORCEINLINE __m256d recip_double4_safe(__m256d x) {
+  if (all_in_range_double4(_mm256_andnot_pd(_mm256_set1_pd(-0.0), x), recip_direct_max))
+    return Kernel(x);
+  __m256d inf = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FF0000000000000LL));
+  __m256d scale;
+  __m256d res = Kernel(reduce_double4(x, scale));
+  res = _mm256_mul_pd(_mm256_mul_pd(res, scale), scale);
+  __m256d zero = _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_EQ_OQ);
+  __m256d special = _mm256_or_pd(zero, _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), x), inf, _CMP_EQ_OQ));
+  return fixup_double4(x, res, zero, special);
+}
+template<__m256d (*Kernel)(__m256d)> static FORCEINLINE __m256d rsqrt_double4_safe(__m256d x) {
+  if (all_in_range_double4(x, rsqrt_direct_max))
+    return Kernel(x);
+  __m256d inf = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FF0000000000000LL));
+  __m256d scale;
+  __m256d res = Kernel(reduce_double4(x, scale));
+  res = _mm256_mul_pd(res, scale);
+  __m256d zero = _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_EQ_OQ);
+  __m256d special = _mm256_or_pd(zero, _mm256_cmp_pd(x, inf, _CMP_EQ_OQ));
+  return fixup_double4(x, res, zero, special);
+}
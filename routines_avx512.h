@@ -0,0 +1,168 @@
+//requires AVX-512F (e.g. -mavx512f or /arch:AVX512)
+//note: vrcp14 / vrsqrt14 give about 14 bits of precision (max relative error 2^-14),
+//and they work on doubles directly, so no conversion to float is necessary
+
+#include <cfloat>
+
+//=================== float =================
+
+//canonical
+static FORCEINLINE __m512 recip_float16_ieee(__m512 x) {
+  return _mm512_div_ps(_mm512_set1_ps(1.0f), x);
+}
+static FORCEINLINE __m512 rsqrt_float16_ieee(__m512 x) {
+  return _mm512_div_ps(_mm512_set1_ps(1.0f), _mm512_sqrt_ps(x));
+}
+//fast approximation
+static FORCEINLINE __m512 recip_float16_fast(__m512 x) {
+  return _mm512_rcp14_ps(x);
+}
+static FORCEINLINE __m512 rsqrt_float16_fast(__m512 x) {
+  return _mm512_rsqrt14_ps(x);
+}
+//with Newton-Raphson
+static FORCEINLINE __m512 recip_float16_nr1(__m512 x) {
+  __m512 res, r;
+  res = _mm512_rcp14_ps(x);
+  r = _mm512_fnmadd_ps(x, res, _mm512_set1_ps(1.0f));
+  res = _mm512_fmadd_ps(res, r, res);
+  return res;
+}
+static FORCEINLINE __m512 rsqrt_float16_nr1(__m512 x) {
+  __m512 three = _mm512_set1_ps(3.0f), half = _mm512_set1_ps(0.5f);
+  __m512 res, muls;
+  res = _mm512_rsqrt14_ps(x);
+  muls = _mm512_fnmadd_ps(_mm512_mul_ps(x, res), res, three);
+  res = _mm512_mul_ps(_mm512_mul_ps(half, res), muls);
+  return res;
+}
+
+//=================== double =================
+
+//canonical
+static FORCEINLINE __m512d recip_double8_ieee(__m512d x) {
+  return _mm512_div_pd(_mm512_set1_pd(1.0), x);
+}
+static FORCEINLINE __m512d rsqrt_double8_ieee(__m512d x) {
+  return _mm512_div_pd(_mm512_set1_pd(1.0), _mm512_sqrt_pd(x));
+}
+//fast approximation (no conversion)
+static FORCEINLINE __m512d recip_double8_fast(__m512d x) {
+  return _mm512_rcp14_pd(x);
+}
+static FORCEINLINE __m512d rsqrt_double8_fast(__m512d x) {
+  return _mm512_rsqrt14_pd(x);
+}
+//with Newton-Raphson
+static FORCEINLINE __m512d recip_double8_nr1(__m512d x) {
+  __m512d res, r;
+  res = _mm512_rcp14_pd(x);
+  r = _mm512_fnmadd_pd(x, res, _mm512_set1_pd(1.0));
+  res = _mm512_fmadd_pd(res, r, res);
+  return res;
+}
+static FORCEINLINE __m512d rsqrt_double8_nr1(__m512d x) {
+  __m512d three = _mm512_set1_pd(3.0), half = _mm512_set1_pd(0.5);
+  __m512d res, muls;
+  res = _mm512_rsqrt14_pd(x);
+  muls = _mm512_fnmadd_pd(_mm512_mul_pd(x, res), res, three);
+  res = _mm512_mul_pd(_mm512_mul_pd(half, res), muls);
+  return res;
+}
+
+//relative correctors (see routines_sse.h)
+//with 14-bit seed, order 4 is enough for full double precision
+
+static FORCEINLINE __m512d recip_double8_r4(__m512d a) {
+  __m512d one = _mm512_set1_pd(1.0);
+  __m512d x = _mm512_rcp14_pd(a);
+  __m512d r = _mm512_fnmadd_pd(a, x, one);
+  __m512d r1 = _mm512_add_pd(r, one);         // r + 1
+  __m512d r21 = _mm512_fmadd_pd(r, r, one);   // r^2 + 1
+  __m512d poly = _mm512_mul_pd(r1, r21);
+  __m512d res = _mm512_mul_pd(poly, x);
+  return res;
+}
+
+static FORCEINLINE __m512d rsqrt_double8_r4(__m512d a) {
+  __m512d one = _mm512_set1_pd(1.0), c1 = _mm512_set1_pd(1.0/2.0), c2 = _mm512_set1_pd(3.0/8.0), c3 = _mm512_set1_pd(15.0/48.0);
+  __m512d x = _mm512_rsqrt14_pd(a);
+  __m512d r = _mm512_fnmadd_pd(_mm512_mul_pd(a, x), x, one);
+  __m512d r2 = _mm512_mul_pd(r, r);
+  __m512d t1 = _mm512_fmadd_pd(c2, r, c1);
+  __m512d poly = _mm512_fmadd_pd(r2, c3, t1);
+  __m512d res = _mm512_fmadd_pd(_mm512_mul_pd(x, r), poly, x);
+  return res;
+}
+
+//=================== division and square root =================
+
+//numerator is folded into the last correction (see routines_sse.h)
+
+//canonical
+static FORCEINLINE __m512 div_float16_ieee(__m512 a, __m512 b) {
+  return _mm512_div_ps(a, b);
+}
+static FORCEINLINE __m512 sqrt_float16_ieee(__m512 x) {
+  return _mm512_sqrt_ps(x);
+}
+//fast approximation
+static FORCEINLINE __m512 div_float16_fast(__m512 a, __m512 b) {
+  return _mm512_mul_ps(a, _mm512_rcp14_ps(b));
+}
+static FORCEINLINE __m512 sqrt_float16_fast(__m512 x) {
+  return _mm512_mul_ps(x, _mm512_rsqrt14_ps(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN))));
+}
+//with one correction
+static FORCEINLINE __m512 div_float16_nr1(__m512 a, __m512 b) {
+  __m512 y = _mm512_rcp14_ps(b);
+  __m512 q = _mm512_mul_ps(a, y);
+  __m512 r = _mm512_fnmadd_ps(b, q, a);
+  return _mm512_fmadd_ps(r, y, q);
+}
+static FORCEINLINE __m512 sqrt_float16_nr1(__m512 x) {
+  __m512 y = _mm512_rsqrt14_ps(_mm512_max_ps(x, _mm512_set1_ps(FLT_MIN)));
+  __m512 s = _mm512_mul_ps(x, y), h = _mm512_mul_ps(y, _mm512_set1_ps(0.5f));
+  __m512 d = _mm512_fnmadd_ps(s, s, x);
+  return _mm512_fmadd_ps(d, h, s);
+}
+
+//canonical
+static FORCEINLINE __m512d div_double8_ieee(__m512d a, __m512d b) {
+  return _mm512_div_pd(a, b);
+}
+static FORCEINLINE __m512d sqrt_double8_ieee(__m512d x) {
+  return _mm512_sqrt_pd(x);
+}
+//fast approximation
+static FORCEINLINE __m512d div_double8_fast(__m512d a, __m512d b) {
+  return _mm512_mul_pd(a, _mm512_rcp14_pd(b));
+}
+static FORCEINLINE __m512d sqrt_double8_fast(__m512d x) {
+  return _mm512_mul_pd(x, _mm512_rsqrt14_pd(_mm512_max_pd(x, _mm512_set1_pd(FLT_MIN))));
+}
+//correction applied to y from given recip / rsqrt kernel
+static FORCEINLINE __m512d div_double8_correct(__m512d a, __m512d b, __m512d y) {
+  __m512d q = _mm512_mul_pd(a, y);
+  __m512d r = _mm512_fnmadd_pd(b, q, a);
+  return _mm512_fmadd_pd(r, y, q);
+}
+static FORCEINLINE __m512d sqrt_double8_correct(__m512d x, __m512d y) {
+  __m512d s = _mm512_mul_pd(x, y), h = _mm512_mul_pd(y, _mm512_set1_pd(0.5));
+  __m512d d = _mm512_fnmadd_pd(s, s, x);
+  return _mm512_fmadd_pd(d, h, s);
+}
+//y from seed: about single precision
+static FORCEINLINE __m512d div_double8_nr1(__m512d a, __m512d b) {
+  return div_double8_correct(a, b, _mm512_rcp14_pd(b));
+}
+static FORCEINLINE __m512d sqrt_double8_nr1(__m512d x) {
+  return sqrt_double8_correct(x, _mm512_rsqrt14_pd(_mm512_max_pd(x, _mm512_set1_pd(FLT_MIN))));
+}
+//y after Newton-Raphson step (e ~ 2^-28): error of result is dominated by rounding
+static FORCEINLINE __m512d div_double8_nr2(__m512d a, __m512d b) {
+  return div_double8_correct(a, b, recip_double8_nr1(b));
+}
+static FORCEINLINE __m512d sqrt_double8_nr2(__m512d x) {
+  return sqrt_double8_correct(x, rsqrt_double8_nr1(_mm512_max_pd(x, _mm512_set1_pd(FLT_MIN))));
+}
@@ -1,3 +1,6 @@
+#include <cfloat>
+#include "safe_ranges.h"
+
 //=================== float =================
 
 //canonical
@@ -178,3 +181,267 @@ static FORCEINLINE __m128d rsqrt_double2_r5(__m128d a) {
   __m128d res = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(x, r), poly), x);
   return res;
 }
+
+//full-range seeds: initial approximation is computed by subtracting bits of input from magic constant,
+//which negates (halves for rsqrt) exponent and approximates mantissa part linearly;
+//unlike conversion to float, it works for all normal inputs with normal result.
+//Seed's residual is within 5.1% (recip) / 6.8% (rsqrt), first corrector reduces it to about 2^-13,
+//and second one gives full precision.
+
+static FORCEINLINE __m128d recip_double2_magic(__m128d a) {
+  __m128d one = _mm_set1_pd(1.0);
+  __m128i magic = _mm_set1_epi64x(0x7FDE623850373513LL);
+  __m128d x = _mm_castsi128_pd(_mm_sub_epi64(magic, _mm_castpd_si128(a)));
+  __m128d r = _mm_sub_pd(one, _mm_mul_pd(a, x));
+  __m128d poly = _mm_add_pd(_mm_mul_pd(r, r), r);  // r^2 + r
+  __m128d res = _mm_add_pd(_mm_mul_pd(poly, x), x);
+  return res;
+}
+
+static FORCEINLINE __m128d recip_double2_magic_r5(__m128d a) {
+  __m128d one = _mm_set1_pd(1.0);
+  __m128d x = recip_double2_magic(a);
+  __m128d r = _mm_sub_pd(one, _mm_mul_pd(a, x));
+  __m128d r2 = _mm_mul_pd(r, r);
+  __m128d r2r = _mm_add_pd(r2, r);      // r^2 + r
+  __m128d r21 = _mm_add_pd(r2, one);    // r^2 + 1
+  __m128d poly = _mm_mul_pd(r2r, r21);
+  __m128d res = _mm_add_pd(_mm_mul_pd(poly, x), x);
+  return res;
+}
+
+static FORCEINLINE __m128d rsqrt_double2_magic(__m128d a) {
+  __m128d one = _mm_set1_pd(1.0), c1 = _mm_set1_pd(1.0/2.0), c2 = _mm_set1_pd(3.0/8.0);
+  __m128i magic = _mm_set1_epi64x(0x5FE6E71B1E8B76CFLL);
+  __m128d x = _mm_castsi128_pd(_mm_sub_epi64(magic, _mm_srli_epi64(_mm_castpd_si128(a), 1)));
+  __m128d r = _mm_sub_pd(one, _mm_mul_pd(_mm_mul_pd(a, x), x));
+  __m128d t1 = _mm_add_pd(_mm_mul_pd(c2, r), c1);
+  __m128d res = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(r, x), t1), x);
+  return res;
+}
+
+static FORCEINLINE __m128d rsqrt_double2_magic_r5(__m128d a) {
+  __m128d one = _mm_set1_pd(1.0), c1 = _mm_set1_pd(1.0/2.0), c2 = _mm_set1_pd(3.0/8.0), c3 = _mm_set1_pd(15.0/48.0), c4 = _mm_set1_pd(105.0/384.0);
+  __m128d x = rsqrt_double2_magic(a);
+  __m128d r = _mm_sub_pd(one, _mm_mul_pd(_mm_mul_pd(a, x), x));
+  __m128d r2 = _mm_mul_pd(r, r);
+  __m128d t1 = _mm_add_pd(_mm_mul_pd(c2, r), c1);
+  __m128d t3 = _mm_add_pd(_mm_mul_pd(c4, r), c3);
+  __m128d poly = _mm_add_pd(_mm_mul_pd(r2, t3), t1);
+  __m128d res = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(x, r), poly), x);
+  return res;
+}
+
+//four doubles at once (see double2x2 in vector_traits.h):
+//both halves are converted into one float vector, so that single rcpps / rsqrtps computes all seeds
+
+static FORCEINLINE double2x2::vec recip_double2x2_fast(double2x2::vec a) {
+  __m128 f = _mm_movelh_ps(_mm_cvtpd_ps(a.v[0]), _mm_cvtpd_ps(a.v[1]));
+  f = _mm_rcp_ps(f);
+  return double2x2::make(_mm_cvtps_pd(f), _mm_cvtps_pd(_mm_movehl_ps(f, f)));
+}
+
+static FORCEINLINE double2x2::vec rsqrt_double2x2_fast(double2x2::vec a) {
+  __m128 f = _mm_movelh_ps(_mm_cvtpd_ps(a.v[0]), _mm_cvtpd_ps(a.v[1]));
+  f = _mm_rsqrt_ps(f);
+  return double2x2::make(_mm_cvtps_pd(f), _mm_cvtps_pd(_mm_movehl_ps(f, f)));
+}
+
+//same corrector as in recip_double2_r5
+static FORCEINLINE double2x2::vec recip_double2x2_r5(double2x2::vec a) {
+  __m128d one = _mm_set1_pd(1.0);
+  double2x2::vec x = recip_double2x2_fast(a), res;
+  for (int i = 0; i < 2; i++) {
+    __m128d r = _mm_sub_pd(one, _mm_mul_pd(a.v[i], x.v[i]));
+    __m128d r2 = _mm_mul_pd(r, r);
+    __m128d r2r = _mm_add_pd(r2, r);      // r^2 + r
+    __m128d r21 = _mm_add_pd(r2, one);    // r^2 + 1
+    __m128d poly = _mm_mul_pd(r2r, r21);
+    res.v[i] = _mm_add_pd(_mm_mul_pd(poly, x.v[i]), x.v[i]);
+  }
+  return res;
+}
+
+//same corrector as in rsqrt_double2_r5
+static FORCEINLINE double2x2::vec rsqrt_double2x2_r5(double2x2::vec a) {
+  __m128d one = _mm_set1_pd(1.0), c1 = _mm_set1_pd(1.0/2.0), c2 = _mm_set1_pd(3.0/8.0), c3 = _mm_set1_pd(15.0/48.0), c4 = _mm_set1_pd(105.0/384.0);
+  double2x2::vec x = rsqrt_double2x2_fast(a), res;
+  for (int i = 0; i < 2; i++) {
+    __m128d r = _mm_sub_pd(one, _mm_mul_pd(_mm_mul_pd(a.v[i], x.v[i]), x.v[i]));
+    __m128d r2 = _mm_mul_pd(r, r);
+    __m128d t1 = _mm_add_pd(_mm_mul_pd(c2, r), c1);
+    __m128d t3 = _mm_add_pd(_mm_mul_pd(c4, r), c3);
+    __m128d poly = _mm_add_pd(_mm_mul_pd(r2, t3), t1);
+    res.v[i] = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(x.v[i], r), poly), x.v[i]);
+  }
+  return res;
+}
+
+//=================== division and square root =================
+
+//a / b and sqrt(x) from approximations y of 1/b and 1/sqrt(x).
+//Naive a * y and x * y have error of y plus rounding, so numerator is folded into the last correction:
+//   q = a y,  q := q + y (a - b q)
+//   s = x y,  s := s + y/2 (x - s^2)
+//relative error of result is e^2 (1.5 e^2 for sqrt), where e is relative error of y.
+//Input of rsqrt is clamped from below by FLT_MIN, so that sqrt(0) = 0 * finite = 0 (not 0 * inf = NaN).
+
+//canonical
+static FORCEINLINE __m128 div_float4_ieee(__m128 a, __m128 b) {
+  return _mm_div_ps(a, b);
+}
+static FORCEINLINE __m128 sqrt_float4_ieee(__m128 x) {
+  return _mm_sqrt_ps(x);
+}
+//fast approximation
+static FORCEINLINE __m128 div_float4_fast(__m128 a, __m128 b) {
+  return _mm_mul_ps(a, _mm_rcp_ps(b));
+}
+static FORCEINLINE __m128 sqrt_float4_fast(__m128 x) {
+  return _mm_mul_ps(x, _mm_rsqrt_ps(_mm_max_ps(x, _mm_set1_ps(FLT_MIN))));
+}
+//with one correction
+static FORCEINLINE __m128 div_float4_nr1(__m128 a, __m128 b) {
+  __m128 y = _mm_rcp_ps(b);
+  __m128 q = _mm_mul_ps(a, y);
+  __m128 r = _mm_sub_ps(a, _mm_mul_ps(b, q));
+  return _mm_add_ps(q, _mm_mul_ps(r, y));
+}
+static FORCEINLINE __m128 sqrt_float4_nr1(__m128 x) {
+  __m128 y = _mm_rsqrt_ps(_mm_max_ps(x, _mm_set1_ps(FLT_MIN)));
+  __m128 s = _mm_mul_ps(x, y), h = _mm_mul_ps(y, _mm_set1_ps(0.5f));
+  __m128 d = _mm_sub_ps(x, _mm_mul_ps(s, s));
+  return _mm_add_ps(s, _mm_mul_ps(d, h));
+}
+
+//canonical
+static FORCEINLINE __m128d div_double2_ieee(__m128d a, __m128d b) {
+  return _mm_div_pd(a, b);
+}
+static FORCEINLINE __m128d sqrt_double2_ieee(__m128d x) {
+  return _mm_sqrt_pd(x);
+}
+//fast approximation (with conversion)
+static FORCEINLINE __m128d div_double2_fast(__m128d a, __m128d b) {
+  return _mm_mul_pd(a, recip_double2_fast(b));
+}
+static FORCEINLINE __m128d sqrt_double2_fast(__m128d x) {
+  return _mm_mul_pd(x, rsqrt_double2_fast(_mm_max_pd(x, _mm_set1_pd(FLT_MIN))));
+}
+//correction applied to y from given recip / rsqrt kernel
+static FORCEINLINE __m128d div_double2_correct(__m128d a, __m128d b, __m128d y) {
+  __m128d q = _mm_mul_pd(a, y);
+  __m128d r = _mm_sub_pd(a, _mm_mul_pd(b, q));
+  return _mm_add_pd(q, _mm_mul_pd(r, y));
+}
+static FORCEINLINE __m128d sqrt_double2_correct(__m128d x, __m128d y) {
+  __m128d s = _mm_mul_pd(x, y), h = _mm_mul_pd(y, _mm_set1_pd(0.5));
+  __m128d d = _mm_sub_pd(x, _mm_mul_pd(s, s));
+  return _mm_add_pd(s, _mm_mul_pd(d, h));
+}
+//y from seed: about single precision
+static FORCEINLINE __m128d div_double2_nr1(__m128d a, __m128d b) {
+  return div_double2_correct(a, b, recip_double2_fast(b));
+}
+static FORCEINLINE __m128d sqrt_double2_nr1(__m128d x) {
+  return sqrt_double2_correct(x, rsqrt_double2_fast(_mm_max_pd(x, _mm_set1_pd(FLT_MIN))));
+}
+//y from cubic corrector (e ~ 2^-34): error of result is dominated by rounding
+static FORCEINLINE __m128d div_double2_r3(__m128d a, __m128d b) {
+  return div_double2_correct(a, b, recip_double2_r3(b));
+}
+static FORCEINLINE __m128d sqrt_double2_r3(__m128d x) {
+  return sqrt_double2_correct(x, rsqrt_double2_r3(_mm_max_pd(x, _mm_set1_pd(FLT_MIN))));
+}
+
+//=================== special values =================
+
+//Kernels above are valid only for normal inputs with normal results (within float range for doubles),
+//and residual contains 0 * inf = NaN for x = 0. Safe variants wrap any kernel and reduce input by exact scaling:
+//   x = x' 2^j 2^j, where x' in [1, 4);   recip(x) = recip(x') 2^-j 2^-j,   rsqrt(x) = rsqrt(x') 2^-j
+//2^-j is built from exponent bits (for subnormals x' is smaller, but still normal);
+//only the last multiplication rounds, so subnormal and overflowing results are rounded once.
+//Results for x = ±0, ±inf (recip) or ±0, +inf (rsqrt) are blended in: ±inf or ±0 with sign of x.
+//NaN (and negative input of rsqrt) gives NaN through the kernel itself.
+//When all lanes are within the range where every kernel is valid (see safe_ranges.h), the kernel is called directly.
+//Note: without DAZ, multiplying subnormal input by 2^-j takes a microcode assist (tens of cycles).
+
+//true if all lanes are within [1 / high, high]
+static FORCEINLINE bool all_in_range_float4(__m128 x, float high) {
+  __m128 ok = _mm_and_ps(_mm_cmpge_ps(x, _mm_set1_ps(1.0f / high)), _mm_cmple_ps(x, _mm_set1_ps(high)));
+  return _mm_movemask_ps(ok) == 0xF;
+}
+//returns x', scale = 2^-j, where j = floor((E + 1) / 2) - 64 for biased exponent E
+static FORCEINLINE __m128 reduce_float4(__m128 x, __m128 &scale) {
+  __m128i e = _mm_srli_epi32(_mm_slli_epi32(_mm_castps_si128(x), 1), 24);
+  __m128i h = _mm_srli_epi32(_mm_add_epi32(e, _mm_set1_epi32(1)), 1);
+  scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(_mm_set1_epi32(127 + 64), h), 23));
+  return _mm_mul_ps(_mm_mul_ps(x, scale), scale);
+}
+//res where special is not set, ±inf (x = ±0) or ±0 (x = ±inf) otherwise
+static FORCEINLINE __m128 fixup_float4(__m128 x, __m128 res, __m128 zero, __m128 special) {
+  __m128 inf = _mm_castsi128_ps(_mm_set1_epi32(0x7F800000));
+  __m128 fix = _mm_or_ps(_mm_and_ps(zero, inf), _mm_and_ps(x, _mm_set1_ps(-0.0f)));
+  return _mm_or_ps(_mm_and_ps(special, fix), _mm_andnot_ps(special, res));
+}
+template<__m128 (*Kernel)(__m128)> static FORCEINLINE __m128 recip_float4_safe(__m128 x) {
+  if (all_in_range_float4(_mm_andnot_ps(_mm_set1_ps(-0.0f), x), recip_direct_max))
+    return Kernel(x);
+  __m128 inf = _mm_castsi128_ps(_mm_set1_epi32(0x7F800000));
+  __m128 scale;
+  __m128 res = Kernel(reduce_float4(x, scale));
+  res = _mm_mul_ps(_mm_mul_ps(res, scale), scale);
+  __m128 zero = _mm_cmpeq_ps(x, _mm_setzero_ps());
+  __m128 special = _mm_or_ps(zero, _mm_cmpeq_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), x), inf));
+  return fixup_float4(x, res, zero, special);
+}
+template<__m128 (*Kernel)(__m128)> static FORCEINLINE __m128 rsqrt_float4_safe(__m128 x) {
+  if (all_in_range_float4(x, rsqrt_direct_max))
+    return Kernel(x);
+  __m128 inf = _mm_castsi128_ps(_mm_set1_epi32(0x7F800000));
+  __m128 scale;
+  __m128 res = Kernel(reduce_float4(x, scale));
+  res = _mm_mul_ps(res, scale);
+  __m128 zero = _mm_cmpeq_ps(x, _mm_setzero_ps());
+  __m128 special = _mm_or_ps(zero, _mm_cmpeq_ps(x, inf));
+  return fixup_float4(x, res, zero, special);
+}
+
+//same for doubles (with the same range, since seeds are computed in float): j = floor((E + 1) / 2) - 512
+static FORCEINLINE bool all_in_range_double2(__m128d x, double high) {
+  __m128d ok = _mm_and_pd(_mm_cmpge_pd(x, _mm_set1_pd(1.0 / high)), _mm_cmple_pd(x, _mm_set1_pd(high)));
+  return _mm_movemask_pd(ok) == 0x3;
+}
+static FORCEINLINE __m128d reduce_double2(__m128d x, __m128d &scale) {
+  __m128i e = _mm_srli_epi64(_mm_slli_epi64(_mm_castpd_si128(x), 1), 53);
+  __m128i h = _mm_srli_epi64(_mm_add_epi64(e, _mm_set1_epi64x(1)), 1);
+  scale = _mm_castsi128_pd(_mm_slli_epi64(_mm_sub_epi64(_mm_set1_epi64x(1023 + 512), h), 52));
+  return _mm_mul_pd(_mm_mul_pd(x, scale), scale);
+}
+static FORCEINLINE __m128d fixup_double2(__m128d x, __m128d res, __m128d zero, __m128d special) {
+  __m128d inf = _mm_castsi128_pd(_mm_set1_epi64x(0x7FF0000000000000LL));
+  __m128d fix = _mm_or_pd(_mm_and_pd(zero, inf), _mm_and_pd(x, _mm_set1_pd(-0.0)));
+  return _mm_or_pd(_mm_and_pd(special, fix), _mm_andnot_pd(special, res));
+}
+template<__m128d (*Kernel)(__m128d)> static FORCEINLINE __m128d recip_double2_safe(__m128d x) {
+  if (all_in_range_double2(_mm_andnot_pd(_mm_set1_pd(-0.0), x), recip_direct_max))
+    return Kernel(x);
+  __m128d inf = _mm_castsi128_pd(_mm_set1_epi64x(0x7FF0000000000000LL));
+  __m128d scale;
+  __m128d res = Kernel(reduce_double2(x, scale));
+  res = _mm_mul_pd(_mm_mul_pd(res, scale), scale);
+  __m128d zero = _mm_cmpeq_pd(x, _mm_setzero_pd());
+  __m128d special = _mm_or_pd(zero, _mm_cmpeq_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), x), inf));
+  return fixup_double2(x, res, zero, special);
+}
+template<__m128d (*Kernel)(__m128d)> static FORCEINLINE __m128d rsqrt_double2_safe(__m128d x) {
+  if (all_in_range_double2(x, rsqrt_direct_max))
+    return Kernel(x);
+  __m128d inf = _mm_castsi128_pd(_mm_set1_epi64x(0x7FF0000000000000LL));
+  __m128d scale;
+  __m128d res = Kernel(reduce_double2(x, scale));
+  res = _mm_mul_pd(res, scale);
+  __m128d zero = _mm_cmpeq_pd(x, _mm_setzero_pd());
+  __m128d special = _mm_or_pd(zero, _mm_cmpeq_pd(x, inf));
+  return fixup_double2(x, res, zero, special);
+}
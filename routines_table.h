@@ -0,0 +1,104 @@
+//requires AVX2 and FMA (e.g. -mavx2 -mfma or /arch:AVX2)
+
+//Seeds from table lookup: mantissa m in [1, 2) is split into 2^Bits intervals
+//(and by parity of exponent for rsqrt), on each interval the function is approximated
+//by linear polynomial c0 + c1 m, with coefficients gathered from table.
+//Exponent of result is computed by integer arithmetic, so all normal inputs with normal result are supported.
+//Relative error of seed is about 2^-(2 Bits + 3), so with Bits >= 8 single cubic corrector gives full double precision.
+
+#include <cmath>
+
+//linear approximation of convex function f on [a, b]:
+//chord is shifted halfway towards the parallel tangent, so that deviations at ends and in the middle are equal
+static void fit_linear_seed(double (*f)(double), double a, double b, double &c0, double &c1) {
+  c1 = (f(b) - f(a)) / (b - a);
+  double chord0 = f(a) - c1 * a;
+  //deviation from chord is unimodal: ternary search for its maximum
+  double lo = a, hi = b;
+  for (int it = 0; it < 100; it++) {
+    double m1 = lo + (hi - lo) / 3.0, m2 = hi - (hi - lo) / 3.0;
+    if (chord0 + c1 * m1 - f(m1) < chord0 + c1 * m2 - f(m2))
+      lo = m1;
+    else
+      hi = m2;
+  }
+  c0 = chord0 - 0.5 * (chord0 + c1 * lo - f(lo));
+}
+
+static double seed_recip(double m) { return 1.0 / m; }
+static double seed_rsqrt(double m) { return 1.0 / std::sqrt(m); }
+static double seed_rsqrt_odd(double m) { return 1.0 / std::sqrt(2.0 * m); }
+
+//index is top Bits of mantissa
+template<int Bits> struct RecipSeedTable {
+  enum { size = 1 << Bits };
+  double c0[size], c1[size];
+  RecipSeedTable() {
+    for (int i = 0; i < size; i++)
+      fit_linear_seed(seed_recip, 1.0 + double(i) / size, 1.0 + double(i + 1) / size, c0[i], c1[i]);
+  }
+  static const RecipSeedTable instance;
+};
+template<int Bits> const RecipSeedTable<Bits> RecipSeedTable<Bits>::instance;
+
+//index is lowest bit of exponent followed by top Bits of mantissa:
+//when unbiased exponent is odd, approximated function is 1/sqrt(2m)
+template<int Bits> struct RsqrtSeedTable {
+  enum { size = 2 << Bits, half = 1 << Bits };
+  double c0[size], c1[size];
+  RsqrtSeedTable() {
+    for (int i = 0; i < half; i++) {
+      double a = 1.0 + double(i) / half, b = 1.0 + double(i + 1) / half;
+      fit_linear_seed(seed_rsqrt_odd, a, b, c0[i], c1[i]);
+      fit_linear_seed(seed_rsqrt, a, b, c0[half + i], c1[half + i]);
+    }
+  }
+  static const RsqrtSeedTable instance;
+};
+template<int Bits> const RsqrtSeedTable<Bits> RsqrtSeedTable<Bits>::instance;
+
+template<int Bits> static FORCEINLINE __m256d recip_double4_table_seed(__m256d a) {
+  const __m256i mantMask = _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL), one = _mm256_set1_epi64x(0x3FF0000000000000LL);
+  __m256i bits = _mm256_castpd_si256(a);
+  __m256i idx = _mm256_and_si256(_mm256_srli_epi64(bits, 52 - Bits), _mm256_set1_epi64x((1 << Bits) - 1));
+  __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, mantMask), one));
+  __m256d c0 = _mm256_i64gather_pd(RecipSeedTable<Bits>::instance.c0, idx, 8);
+  __m256d c1 = _mm256_i64gather_pd(RecipSeedTable<Bits>::instance.c1, idx, 8);
+  __m256i s = _mm256_castpd_si256(_mm256_fmadd_pd(c1, m, c0));
+  //1/a = 1/m * 2^(1023 - E), where E is biased exponent
+  __m256i expo = _mm256_andnot_si256(mantMask, bits);
+  return _mm256_castsi256_pd(_mm256_sub_epi64(_mm256_add_epi64(s, one), expo));
+}
+
+template<int Bits> static FORCEINLINE __m256d rsqrt_double4_table_seed(__m256d a) {
+  const __m256i mantMask = _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL), one = _mm256_set1_epi64x(0x3FF0000000000000LL);
+  __m256i bits = _mm256_castpd_si256(a);
+  __m256i idx = _mm256_and_si256(_mm256_srli_epi64(bits, 52 - Bits), _mm256_set1_epi64x((2 << Bits) - 1));
+  __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, mantMask), one));
+  __m256d c0 = _mm256_i64gather_pd(RsqrtSeedTable<Bits>::instance.c0, idx, 8);
+  __m256d c1 = _mm256_i64gather_pd(RsqrtSeedTable<Bits>::instance.c1, idx, 8);
+  __m256i s = _mm256_castpd_si256(_mm256_fmadd_pd(c1, m, c0));
+  //1/sqrt(a) = seed * 2^-k, where k = floor((E - 1023) / 2) = floor((E + 1) / 2) - 512
+  __m256i k = _mm256_slli_epi64(_mm256_srli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1LL << 52)), 53), 52);
+  return _mm256_castsi256_pd(_mm256_sub_epi64(_mm256_add_epi64(s, _mm256_set1_epi64x(512LL << 52)), k));
+}
+
+//seed followed by cubic corrector (same as recip_double4_r3 / rsqrt_double4_r3)
+
+template<int Bits> static FORCEINLINE __m256d recip_double4_table_r3(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0);
+  __m256d x = recip_double4_table_seed<Bits>(a);
+  __m256d r = _mm256_fnmadd_pd(a, x, one);
+  __m256d poly = _mm256_fmadd_pd(r, r, r);    // r^2 + r
+  __m256d res = _mm256_fmadd_pd(poly, x, x);
+  return res;
+}
+
+template<int Bits> static FORCEINLINE __m256d rsqrt_double4_table_r3(__m256d a) {
+  __m256d one = _mm256_set1_pd(1.0), c1 = _mm256_set1_pd(1.0/2.0), c2 = _mm256_set1_pd(3.0/8.0);
+  __m256d x = rsqrt_double4_table_seed<Bits>(a);
+  __m256d r = _mm256_fnmadd_pd(_mm256_mul_pd(a, x), x, one);
+  __m256d t1 = _mm256_fmadd_pd(c2, r, c1);
+  __m256d res = _mm256_fmadd_pd(_mm256_mul_pd(r, x), t1, x);
+  return res;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+//Inputs within which safe variants (recip_<vec>_safe, rsqrt_<vec>_safe) call kernels directly, as [1 / max, max]:
+//  recip: [2^-62, 2^62], since kernels may square their approximation (nr1 computes x y y),
+//         and rcpps flushes results below 2^-126 to zero;
+//  rsqrt: [2^-126, 2^126], where both seed and result are normal.
+
+#include <cfloat>
+
+const float recip_direct_max = 4611686018427387904.0f;    //2^62
+const float rsqrt_direct_max = 1.0f / FLT_MIN;             //2^126
@@ -0,0 +1,82 @@
+#pragma once
+
+//Persistent pool of threads for batch kernels.
+//run(func) calls func(index) for every index in [0, size()) in parallel and waits until all calls return:
+//index 0 runs on the calling thread, others on workers, which sleep on condition variable between runs
+//(so no threads are created per call). Workers can be pinned to logical CPUs 1, 2, ..., size() - 1
+//(modulo number of CPUs), so that the same chunk of data is always processed by the same core.
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "affinity.h"
+
+class ThreadPool {
+public:
+  ThreadPool(int threadsNum, bool pin) : task(0), generation(0), pending(0), stopping(false) {
+    int cpus = std::max(int(std::thread::hardware_concurrency()), 1);
+    for (int t = 1; t < threadsNum; t++)
+      workers.push_back(std::thread(&ThreadPool::worker, this, t, pin ? t % cpus : -1));
+  }
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (size_t t = 0; t < workers.size(); t++)
+      workers[t].join();
+  }
+
+  int size() const { return int(workers.size()) + 1; }
+
+  void run(const std::function<void(int)> &func) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      task = &func;
+      pending = int(workers.size());
+      generation++;
+    }
+    wake.notify_all();
+    func(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return pending == 0; });
+    task = 0;
+  }
+
+private:
+  ThreadPool(const ThreadPool&);
+  ThreadPool &operator= (const ThreadPool&);
+
+  void worker(int index, int cpu) {
+    if (cpu >= 0)
+      pin_to_cpu(cpu);
+    unsigned long long seen = 0;
+    while (true) {
+      const std::function<void(int)> *func;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&]() { return stopping || generation != seen; });
+        if (stopping)
+          return;
+        seen = generation;
+        func = task;
+      }
+      (*func)(index);
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--pending == 0)
+        done.notify_one();
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake, done;
+  const std::function<void(int)> *task;
+  unsigned long long generation;    //incremented by every run
+  int pending;                      //workers which have not finished current run
+  bool stopping;
+};
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <stddef.h>
+#include <immintrin.h>
+#include "compiler.h"
+
+//32-bit lanes multiplied modulo 2^32 (SSE2 has no pmulld)
+static FORCEINLINE __m128i mullo_epi32(__m128i a, __m128i b) {
+#ifdef __SSE4_1__
+  return _mm_mullo_epi32(a, b);
+#else
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+//Each vector type used by kernels is described by a traits struct,
+//named the same way as in kernel names (e.g. recip_float4_nr1 works on float4).
+//Generic loops take these structs as template parameters.
+
+struct float4 {
+  typedef __m128 vec;
+  typedef float elem;
+  enum { width = 4 };
+  static FORCEINLINE vec load(const elem *p) { return _mm_load_ps(p); }
+  static FORCEINLINE vec loadu(const elem *p) { return _mm_loadu_ps(p); }
+  static FORCEINLINE void store(elem *p, vec x) { _mm_store_ps(p, x); }
+  static FORCEINLINE void storeu(elem *p, vec x) { _mm_storeu_ps(p, x); }
+  static FORCEINLINE vec set1(elem x) { return _mm_set1_ps(x); }
+  static FORCEINLINE vec zero() { return _mm_setzero_ps(); }
+  static FORCEINLINE vec add(vec a, vec b) { return _mm_add_ps(a, b); }
+  static FORCEINLINE vec sub(vec a, vec b) { return _mm_sub_ps(a, b); }
+  static FORCEINLINE vec mul(vec a, vec b) { return _mm_mul_ps(a, b); }
+  static FORCEINLINE vec div(vec a, vec b) { return _mm_div_ps(a, b); }
+  static FORCEINLINE vec min(vec a, vec b) { return _mm_min_ps(a, b); }
+  static FORCEINLINE vec max(vec a, vec b) { return _mm_max_ps(a, b); }
+  static FORCEINLINE vec abs(vec x) { return _mm_andnot_ps(set1(-0.0f), x); }
+  //a * b + c and c - a * b, fused when FMA is enabled
+  static FORCEINLINE vec fmadd(vec a, vec b, vec c) {
+#ifdef __FMA__
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return add(mul(a, b), c);
+#endif
+  }
+  static FORCEINLINE vec fnmadd(vec a, vec b, vec c) {
+#ifdef __FMA__
+    return _mm_fnmadd_ps(a, b, c);
+#else
+    return sub(c, mul(a, b));
+#endif
+  }
+  //floats with bit patterns first, first + 1, ...
+  static FORCEINLINE vec consecutive_bits(unsigned first) {
+    return _mm_castsi128_ps(_mm_add_epi32(_mm_set1_epi32(int(first)), _mm_setr_epi32(0, 1, 2, 3)));
+  }
+  //lanes with equal bit patterns (unlike eq_mask, distinguishes -0 from +0)
+  static FORCEINLINE int same_bits_mask(vec a, vec b) {
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_castps_si128(a), _mm_castps_si128(b))));
+  }
+  //comparisons return bit mask of lanes
+  static FORCEINLINE int gt_mask(vec a, vec b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+  static FORCEINLINE int eq_mask(vec a, vec b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+  static FORCEINLINE int nan_mask(vec x) { return _mm_movemask_ps(_mm_cmpunord_ps(x, x)); }
+  static FORCEINLINE void stream(elem *p, vec x) { _mm_stream_ps(p, x); }
+  //first k < width elements, the rest is filled with ones
+  static FORCEINLINE vec load_partial(const elem *p, size_t k) {
+    elem tmp[width];
+    for (size_t i = 0; i < width; i++)
+      tmp[i] = (i < k ? p[i] : elem(1));
+    return loadu(tmp);
+  }
+  static FORCEINLINE void store_partial(elem *p, size_t k, vec x) {
+    elem tmp[width];
+    storeu(tmp, x);
+    for (size_t i = 0; i < k; i++)
+      p[i] = tmp[i];
+  }
+};
+
+struct double2 {
+  typedef __m128d vec;
+  typedef double elem;
+  enum { width = 2 };
+  static FORCEINLINE vec load(const elem *p) { return _mm_load_pd(p); }
+  static FORCEINLINE vec loadu(const elem *p) { return _mm_loadu_pd(p); }
+  static FORCEINLINE void store(elem *p, vec x) { _mm_store_pd(p, x); }
+  static FORCEINLINE void storeu(elem *p, vec x) { _mm_storeu_pd(p, x); }
+  static FORCEINLINE vec set1(elem x) { return _mm_set1_pd(x); }
+  static FORCEINLINE vec zero() { return _mm_setzero_pd(); }
+  static FORCEINLINE vec add(vec a, vec b) { return _mm_add_pd(a, b); }
+  static FORCEINLINE vec sub(vec a, vec b) { return _mm_sub_pd(a, b); }
+  static FORCEINLINE vec mul(vec a, vec b) { return _mm_mul_pd(a, b); }
+  static FORCEINLINE vec div(vec a, vec b) { return _mm_div_pd(a, b); }
+  static FORCEINLINE vec min(vec a, vec b) { return _mm_min_pd(a, b); }
+  static FORCEINLINE vec max(vec a, vec b) { return _mm_max_pd(a, b); }
+  static FORCEINLINE vec abs(vec x) { return _mm_andnot_pd(set1(-0.0), x); }
+  //a * b + c and c - a * b, fused when FMA is enabled
+  static FORCEINLINE vec fmadd(vec a, vec b, vec c) {
+#ifdef __FMA__
+    return _mm_fmadd_pd(a, b, c);
+#else
+    return add(mul(a, b), c);
+#endif
+  }
+  static FORCEINLINE vec fnmadd(vec a, vec b, vec c) {
+#ifdef __FMA__
+    return _mm_fnmadd_pd(a, b, c);
+#else
+    return sub(c, mul(a, b));
+#endif
+  }
+  //comparisons return bit mask of lanes
+  static FORCEINLINE int gt_mask(vec a, vec b) { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+  static FORCEINLINE int eq_mask(vec a, vec b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+  static FORCEINLINE int nan_mask(vec x) { return _mm_movemask_pd(_mm_cmpunord_pd(x, x)); }
+  static FORCEINLINE void stream(elem *p, vec x) { _mm_stream_pd(p, x); }
+  //first k < width elements, the rest is filled with ones
+  static FORCEINLINE vec load_partial(const elem *p, size_t k) {
+    elem tmp[width];
+    for (size_t i = 0; i < width; i++)
+      tmp[i] = (i < k ? p[i] : elem(1));
+    return loadu(tmp);
+  }
+  static FORCEINLINE void store_partial(elem *p, size_t k, vec x) {
+    elem tmp[width];
+    storeu(tmp, x);
+    for (size_t i = 0; i < k; i++)
+      p[i] = tmp[i];
+  }
+};
+
+//two SSE2 vectors processed together, so that kernels can share some work between them
+struct double2x2 {
+  struct vec { __m128d v[2]; };
+  typedef double elem;
+  enum { width = 4 };
+  static FORCEINLINE vec make(__m128d lo, __m128d hi) { vec res = {{lo, hi}}; return res; }
+  static FORCEINLINE vec load(const elem *p) { return make(_mm_load_pd(p), _mm_load_pd(p + 2)); }
+  static FORCEINLINE vec loadu(const elem *p) { return make(_mm_loadu_pd(p), _mm_loadu_pd(p + 2)); }
+  static FORCEINLINE void store(elem *p, vec x) { _mm_store_pd(p, x.v[0]); _mm_store_pd(p + 2, x.v[1]); }
+  static FORCEINLINE void storeu(elem *p, vec x) { _mm_storeu_pd(p, x.v[0]); _mm_storeu_pd(p + 2, x.v[1]); }
+  static FORCEINLINE vec set1(elem x) { return make(_mm_set1_pd(x), _mm_set1_pd(x)); }
+  static FORCEINLINE vec zero() { return make(_mm_setzero_pd(), _mm_setzero_pd()); }
+  static FORCEINLINE vec add(vec a, vec b) { return make(_mm_add_pd(a.v[0], b.v[0]), _mm_add_pd(a.v[1], b.v[1])); }
+  static FORCEINLINE vec sub(vec a, vec b) { return make(_mm_sub_pd(a.v[0], b.v[0]), _mm_sub_pd(a.v[1], b.v[1])); }
+  static FORCEINLINE vec mul(vec a, vec b) { return make(_mm_mul_pd(a.v[0], b.v[0]), _mm_mul_pd(a.v[1], b.v[1])); }
+  static FORCEINLINE vec div(vec a, vec b) { return make(_mm_div_pd(a.v[0], b.v[0]), _mm_div_pd(a.v[1], b.v[1])); }
+  static FORCEINLINE vec min(vec a, vec b) { return make(_mm_min_pd(a.v[0], b.v[0]), _mm_min_pd(a.v[1], b.v[1])); }
+  static FORCEINLINE vec max(vec a, vec b) { return make(_mm_max_pd(a.v[0], b.v[0]), _mm_max_pd(a.v[1], b.v[1])); }
+  static FORCEINLINE vec abs(vec x) { return make(double2::abs(x.v[0]), double2::abs(x.v[1])); }
+  static FORCEINLINE vec fmadd(vec a, vec b, vec c) { return make(double2::fmadd(a.v[0], b.v[0], c.v[0]), double2::fmadd(a.v[1], b.v[1], c.v[1])); }
+  static FORCEINLINE vec fnmadd(vec a, vec b, vec c) { return make(double2::fnmadd(a.v[0], b.v[0], c.v[0]), double2::fnmadd(a.v[1], b.v[1], c.v[1])); }
+  //comparisons return bit mask of lanes
+  static FORCEINLINE int gt_mask(vec a, vec b) { return double2::gt_mask(a.v[0], b.v[0]) | double2::gt_mask(a.v[1], b.v[1]) << 2; }
+  static FORCEINLINE int eq_mask(vec a, vec b) { return double2::eq_mask(a.v[0], b.v[0]) | double2::eq_mask(a.v[1], b.v[1]) << 2; }
+  static FORCEINLINE int nan_mask(vec x) { return double2::nan_mask(x.v[0]) | double2::nan_mask(x.v[1]) << 2; }
+  static FORCEINLINE void stream(elem *p, vec x) { _mm_stream_pd(p, x.v[0]); _mm_stream_pd(p + 2, x.v[1]); }
+  //first k < width elements, the rest is filled with ones
+  static FORCEINLINE vec load_partial(const elem *p, size_t k) {
+    elem tmp[width];
+    for (size_t i = 0; i < width; i++)
+      tmp[i] = (i < k ? p[i] : elem(1));
+    return loadu(tmp);
+  }
+  static FORCEINLINE void store_partial(elem *p, size_t k, vec x) {
+    elem tmp[width];
+    storeu(tmp, x);
+    for (size_t i = 0; i < k; i++)
+      p[i] = tmp[i];
+  }
+};
+
+#ifdef __AVX__
+struct float8 {
+  typedef __m256 vec;
+  typedef float elem;
+  enum { width = 8 };
+  static FORCEINLINE vec load(const elem *p) { return _mm256_load_ps(p); }
+  static FORCEINLINE vec loadu(const elem *p) { return _mm256_loadu_ps(p); }
+  static FORCEINLINE void store(elem *p, vec x) { _mm256_store_ps(p, x); }
+  static FORCEINLINE void storeu(elem *p, vec x) { _mm256_storeu_ps(p, x); }
+  static FORCEINLINE vec set1(elem x) { return _mm256_set1_ps(x); }
+  static FORCEINLINE vec zero() { return _mm256_setzero_ps(); }
+  static FORCEINLINE vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+  static FORCEINLINE vec sub(vec a, vec b) { return _mm256_sub_ps(a, b); }
+  static FORCEINLINE vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+  static FORCEINLINE vec div(vec a, vec b) { return _mm256_div_ps(a, b); }
+  static FORCEINLINE vec min(vec a, vec b) { return _mm256_min_ps(a, b); }
+  static FORCEINLINE vec max(vec a, vec b) { return _mm256_max_ps(a, b); }
+  static FORCEINLINE vec abs(vec x) { return _mm256_andnot_ps(set1(-0.0f), x); }
+  //a * b + c and c - a * b, fused when FMA is enabled
+  static FORCEINLINE vec fmadd(vec a, vec b, vec c) {
+#ifdef __FMA__
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return add(mul(a, b), c);
+#endif
+  }
+  static FORCEINLINE vec fnmadd(vec a, vec b, vec c) {
+#ifdef __FMA__
+    return _mm256_fnmadd_ps(a, b, c);
+#else
+    return sub(c, mul(a, b));
+#endif
+  }
+#ifdef __AVX2__
+  //floats with bit patterns first, first + 1, ...
+  static FORCEINLINE vec consecutive_bits(unsigned first) {
+    return _mm256_castsi256_ps(_mm256_add_epi32(_mm256_set1_epi32(int(first)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+  }
+  static FORCEINLINE int same_bits_mask(vec a, vec b) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_castps_si256(a), _mm256_castps_si256(b))));
+  }
+#endif
+  //comparisons return bit mask of lanes
+  static FORCEINLINE int gt_mask(vec a, vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+  static FORCEINLINE int eq_mask(vec a, vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+  static FORCEINLINE int nan_mask(vec x) { return _mm256_movemask_ps(_mm256_cmp_ps(x, x, _CMP_UNORD_Q)); }
+  static FORCEINLINE void stream(elem *p, vec x) { _mm256_stream_ps(p, x); }
+  static FORCEINLINE __m256i tail_mask(size_t k) {
+    static const int table[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+    return _mm256_loadu_si256((const __m256i*)(table + 8 - k));
+  }
+  //first k < width elements, the rest is filled with ones
+  static FORCEINLINE vec load_partial(const elem *p, size_t k) {
+    __m256i mask = tail_mask(k);
+    return _mm256_blendv_ps(set1(1.0f), _mm256_maskload_ps(p, mask), _mm256_castsi256_ps(mask));
+  }
+  static FORCEINLINE void store_partial(elem *p, size_t k, vec x) { _mm256_maskstore_ps(p, tail_mask(k), x); }
+};
+
+struct double4 {
+  typedef __m256d vec;
+  typedef double elem;
+  enum { width = 4 };
+  static FORCEINLINE vec load(const elem *p) { return _mm256_load_pd(p); }
+  static FORCEINLINE vec loadu(const elem *p) { return _mm256_loadu_pd(p); }
+  static FORCEINLINE void store(elem *p, vec x) { _mm256_store_pd(p, x); }
+  static FORCEINLINE void storeu(elem *p, vec x) { _mm256_storeu_pd(p, x); }
+  static FORCEINLINE vec set1(elem x) { return _mm256_set1_pd(x); }
+  static FORCEINLINE vec zero() { return _mm256_setzero_pd(); }
+  static FORCEINLINE vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+  static FORCEINLINE vec sub(vec a, vec b) { return _mm256_sub_pd(a, b); }
+  static FORCEINLINE vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+  static FORCEINLINE vec div(vec a, vec b) { return _mm256_div_pd(a, b); }
+  static FORCEINLINE vec min(vec a, vec b) { return _mm256_min_pd(a, b); }
+  static FORCEINLINE vec max(vec a, vec b) { return _mm256_max_pd(a, b); }
+  static FORCEINLINE vec abs(vec x) { return _mm256_andnot_pd(set1(-0.0), x); }
+  //a * b + c and c - a * b, fused when FMA is enabled
+  static FORCEINLINE vec fmadd(vec a, vec b, vec c) {
+#ifdef __FMA__
+    return _mm256_fmadd_pd(a, b, c);
+#else
+    return add(mul(a, b), c);
+#endif
+  }
+  static FORCEINLINE vec fnmadd(vec a, vec b, vec c) {
+#ifdef __FMA__
+    return _mm256_fnmadd_pd(a, b, c);
+#else
+    return sub(c, mul(a, b));
+#endif
+  }
+  //comparisons return bit mask of lanes
+  static FORCEINLINE int gt_mask(vec a, vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+  static FORCEINLINE int eq_mask(vec a, vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+  static FORCEINLINE int nan_mask(vec x) { return _mm256_movemask_pd(_mm256_cmp_pd(x, x, _CMP_UNORD_Q)); }
+  static FORCEINLINE void stream(elem *p, vec x) { _mm256_stream_pd(p, x); }
+  static FORCEINLINE __m256i tail_mask(size_t k) {
+    static const long long table[8] = {-1, -1, -1, -1, 0, 0, 0, 0};
+    return _mm256_loadu_si256((const __m256i*)(table + 4 - k));
+  }
+  //first k < width elements, the rest is filled with ones
+  static FORCEINLINE vec load_partial(const elem *p, size_t k) {
+    __m256i mask = tail_mask(k);
+    return _mm256_blendv_pd(set1(1.0), _mm256_maskload_pd(p, mask), _mm256_castsi256_pd(mask));
+  }
+  static FORCEINLINE void store_partial(elem *p, size_t k, vec x) { _mm256_maskstore_pd(p, tail_mask(k), x); }
+};
+#endif
+
+#ifdef __AVX512F__
+struct float16 {
+  typedef __m512 vec;
+  typedef float elem;
+  enum { width = 16 };
+  static FORCEINLINE vec load(const elem *p) { return _mm512_load_ps(p); }
+  static FORCEINLINE vec loadu(const elem *p) { return _mm512_loadu_ps(p); }
+  static FORCEINLINE void store(elem *p, vec x) { _mm512_store_ps(p, x); }
+  static FORCEINLINE void storeu(elem *p, vec x) { _mm512_storeu_ps(p, x); }
+  static FORCEINLINE vec set1(elem x) { return _mm512_set1_ps(x); }
+  static FORCEINLINE vec zero() { return _mm512_setzero_ps(); }
+  static FORCEINLINE vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+  static FORCEINLINE vec sub(vec a, vec b) { return _mm512_sub_ps(a, b); }
+  static FORCEINLINE vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+  static FORCEINLINE vec div(vec a, vec b) { return _mm512_div_ps(a, b); }
+  static FORCEINLINE vec min(vec a, vec b) { return _mm512_min_ps(a, b); }
+  static FORCEINLINE vec max(vec a, vec b) { return _mm512_max_ps(a, b); }
+  static FORCEINLINE vec abs(vec x) { return _mm512_abs_ps(x); }
+  //a * b + c and c - a * b
+  static FORCEINLINE vec fmadd(vec a, vec b, vec c) { return _mm512_fmadd_ps(a, b, c); }
+  static FORCEINLINE vec fnmadd(vec a, vec b, vec c) { return _mm512_fnmadd_ps(a, b, c); }
+  //floats with bit patterns first, first + 1, ...
+  static FORCEINLINE vec consecutive_bits(unsigned first) {
+    return _mm512_castsi512_ps(_mm512_add_epi32(_mm512_set1_epi32(int(first)), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)));
+  }
+  static FORCEINLINE int same_bits_mask(vec a, vec b) { return _mm512_cmpeq_epi32_mask(_mm512_castps_si512(a), _mm512_castps_si512(b)); }
+  //comparisons return bit mask of lanes
+  static FORCEINLINE int gt_mask(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+  static FORCEINLINE int eq_mask(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+  static FORCEINLINE int nan_mask(vec x) { return _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q); }
+  static FORCEINLINE void stream(elem *p, vec x) { _mm512_stream_ps(p, x); }
+  //first k < width elements, the rest is filled with ones
+  static FORCEINLINE vec load_partial(const elem *p, size_t k) { return _mm512_mask_loadu_ps(set1(1.0f), __mmask16((1u << k) - 1), p); }
+  static FORCEINLINE void store_partial(elem *p, size_t k, vec x) { _mm512_mask_storeu_ps(p, __mmask16((1u << k) - 1), x); }
+};
+
+struct double8 {
+  typedef __m512d vec;
+  typedef double elem;
+  enum { width = 8 };
+  static FORCEINLINE vec load(const elem *p) { return _mm512_load_pd(p); }
+  static FORCEINLINE vec loadu(const elem *p) { return _mm512_loadu_pd(p); }
+  static FORCEINLINE void store(elem *p, vec x) { _mm512_store_pd(p, x); }
+  static FORCEINLINE void storeu(elem *p, vec x) { _mm512_storeu_pd(p, x); }
+  static FORCEINLINE vec set1(elem x) { return _mm512_set1_pd(x); }
+  static FORCEINLINE vec zero() { return _mm512_setzero_pd(); }
+  static FORCEINLINE vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+  static FORCEINLINE vec sub(vec a, vec b) { return _mm512_sub_pd(a, b); }
+  static FORCEINLINE vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+  static FORCEINLINE vec div(vec a, vec b) { return _mm512_div_pd(a, b); }
+  static FORCEINLINE vec min(vec a, vec b) { return _mm512_min_pd(a, b); }
+  static FORCEINLINE vec max(vec a, vec b) { return _mm512_max_pd(a, b); }
+  static FORCEINLINE vec abs(vec x) { return _mm512_abs_pd(x); }
+  //a * b + c and c - a * b
+  static FORCEINLINE vec fmadd(vec a, vec b, vec c) { return _mm512_fmadd_pd(a, b, c); }
+  static FORCEINLINE vec fnmadd(vec a, vec b, vec c) { return _mm512_fnmadd_pd(a, b, c); }
+  //comparisons return bit mask of lanes
+  static FORCEINLINE int gt_mask(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+  static FORCEINLINE int eq_mask(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+  static FORCEINLINE int nan_mask(vec x) { return _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q); }
+  static FORCEINLINE void stream(elem *p, vec x) { _mm512_stream_pd(p, x); }
+  //first k < width elements, the rest is filled with ones
+  static FORCEINLINE vec load_partial(const elem *p, size_t k) { return _mm512_mask_loadu_pd(set1(1.0), __mmask8((1u << k) - 1), p); }
+  static FORCEINLINE void store_partial(elem *p, size_t k, vec x) { _mm512_mask_storeu_pd(p, __mmask8((1u << k) - 1), x); }
+};
+#endif